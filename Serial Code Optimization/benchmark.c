@@ -0,0 +1,282 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <getopt.h> /* getopt */
+
+#include "matriz.h"
+#include "utils.h"
+#include "perfevent.h"
+#include "roofline.h"
+
+#define DEF_REPETICOES 5
+#define DEF_AQUECIMENTO 1
+
+// Quantil da normal padrão para intervalo de confiança de 95%
+#define Z_95 1.959963985
+
+// Operandos de uma ordem 'n'
+typedef struct {
+  int n, lda;
+  MatRow A, B, C;
+  Vetor v, res;
+} Operandos_t;
+
+/**
+ * Exibe mensagem de erro indicando forma de uso do programa e termina
+ * o programa.
+ */
+static void usage(char *progname)
+{
+  fprintf(stderr, "Forma de uso: %s [ -r <repeticoes> ] [ -w <aquecimento> ] [ -c ] [ -o <arquivo.csv> ] [ -R <maquina.csv> ] <ordem> [ <ordem> ... ]\n", progname);
+  exit(1);
+}
+
+/* Zera a saída do kernel 'k' (fora da região medida) */
+static void zeraSaida(kernel_t k, Operandos_t *op)
+{
+  if (k == kMatVet || k == kMatVetOtim)
+    memset(op->res, 0, op->n * sizeof(real_t));
+  else
+    memset(op->C, 0, (size_t)op->n * op->lda * sizeof(real_t));
+}
+
+static void executaKernel(kernel_t k, Operandos_t *op)
+{
+  switch (k)
+  {
+  case kMatVet:
+    multMatVet(op->A, op->v, op->n, op->n, op->lda, op->res);
+    break;
+  case kMatVetOtim:
+    multMatVet_otim(op->A, op->v, op->n, op->n, op->lda, op->res);
+    break;
+  case kMatMat:
+    multMatMat(op->A, op->B, op->n, op->lda, op->C);
+    break;
+  case kMatMatOtim:
+    multMatMat_otim(op->A, op->B, op->n, op->lda, op->C);
+    break;
+  default:
+    break;
+  }
+}
+
+static int comparaTempo(const void *a, const void *b)
+{
+  rtime_t ta = *(const rtime_t *)a, tb = *(const rtime_t *)b;
+  return (ta > tb) - (ta < tb);
+}
+
+/**
+ * Calcula mínimo, mediana e intervalo de confiança de 95% da mediana a
+ * partir das 'r' amostras (ordena 'tempos'). O intervalo usa as
+ * estatísticas de ordem da distribuição binomial, sem supor normalidade
+ * dos tempos.
+ */
+static void estatisticas(rtime_t *tempos, int r, rtime_t *min, rtime_t *mediana,
+                         rtime_t *icInf, rtime_t *icSup)
+{
+  qsort(tempos, r, sizeof(rtime_t), comparaTempo);
+
+  *min = tempos[0];
+  *mediana = (r % 2) ? tempos[r / 2] : 0.5 * (tempos[r / 2 - 1] + tempos[r / 2]);
+
+  // Postos (base 1) do intervalo de confiança da mediana
+  int inf = (int)floor((r - Z_95 * sqrt(r)) / 2.0);
+  int sup = (int)ceil(1.0 + (r + Z_95 * sqrt(r)) / 2.0);
+
+  if (inf < 1)
+    inf = 1;
+  if (sup > r)
+    sup = r;
+
+  *icInf = tempos[inf - 1];
+  *icSup = tempos[sup - 1];
+}
+
+/**
+ * Programa principal
+ * Forma de uso: benchmark [ -r <rep> ] [ -w <aq> ] [ -c ] [ -o <arq> ] [ -R <arq> ] <ordem> ...
+ * -r <rep>: número de execuções medidas de cada kernel (padrão 5)
+ * -w <aq>: número de execuções de aquecimento, não medidas (padrão 1)
+ * -c: não lê contadores de hardware
+ * -o <arq>: arquivo CSV de saída (padrão: saída padrão)
+ * -R <arq>: mede banda de memória e pico de FLOPS da máquina com as sondas
+ *           de 'roofline.c' e grava 'banda_gbs,pico_gflops' em <arq>
+ *
+ * Gera uma linha CSV por kernel e ordem:
+ *   kernel,n,rep,min_ms,mediana_ms,ic95_inf_ms,ic95_sup_ms,mflops,
+ *   ciclos,instrucoes,llc_ref,llc_miss,ia_modelo,ia_medida,energia_j
+ * Os contadores e a energia do pacote (RAPL, ver 'leEnergia()') são médias
+ * por execução; 'nan' se indisponíveis.
+ * 'ia_modelo' é a intensidade aritmética [FLOP/byte] do modelo de tráfego
+ * de 'bytesKernel()'; 'ia_medida' usa as falhas na L3 (64 bytes cada).
+ */
+int main(int argc, char *argv[])
+{
+  int repeticoes = DEF_REPETICOES, aquecimento = DEF_AQUECIMENTO;
+  int usaContadores = 1, opt;
+  FILE *saida = stdout;
+  char *arqMaquina = NULL;
+  ContadoresHW_t cont;
+
+  /* =============== TRATAMENTO DE LINHA DE COMANDO =============== */
+
+  while ((opt = getopt(argc, argv, "r:w:co:R:")) != -1)
+  {
+    switch (opt)
+    {
+    case 'r':
+      repeticoes = atoi(optarg);
+      if (repeticoes < 1)
+        usage(argv[0]);
+      break;
+    case 'w':
+      aquecimento = atoi(optarg);
+      if (aquecimento < 0)
+        usage(argv[0]);
+      break;
+    case 'c':
+      usaContadores = 0;
+      break;
+    case 'o':
+      if (!(saida = fopen(optarg, "w")))
+      {
+        perror(optarg);
+        exit(1);
+      }
+      break;
+    case 'R':
+      arqMaquina = optarg;
+      break;
+    default:
+      usage(argv[0]);
+    }
+  }
+
+  if (optind >= argc)
+    usage(argv[0]);
+
+  /* ================ FIM DO TRATAMENTO DE LINHA DE COMANDO ========= */
+
+  if (arqMaquina)
+  {
+    Maquina_t maq;
+    FILE *arq = fopen(arqMaquina, "w");
+
+    if (!arq)
+    {
+      perror(arqMaquina);
+      exit(1);
+    }
+
+    fprintf(stderr, "--->>  Sondas de banda e FLOPS\n");
+    mediMaquina(&maq);
+    fprintf(arq, "banda_gbs,pico_gflops\n%.10lg,%.10lg\n", maq.banda, maq.pico);
+    fclose(arq);
+  }
+
+  for (int e = 0; e < NUM_EVENTOS; ++e)
+    cont.fd[e] = -1;
+  cont.fdEnergia = -1;
+
+  if (usaContadores && !abreContadores(&cont))
+    fprintf(stderr, "AVISO: contadores de hardware indisponíveis (perf_event_paranoid?)\n");
+  if (usaContadores && cont.fdEnergia < 0)
+    fprintf(stderr, "AVISO: energia (RAPL 'power/energy-pkg/') indisponível\n");
+
+  rtime_t *tempos = (rtime_t *)malloc(repeticoes * sizeof(rtime_t));
+
+  fprintf(saida, "kernel,n,rep,min_ms,mediana_ms,ic95_inf_ms,ic95_sup_ms,mflops,"
+                 "ciclos,instrucoes,llc_ref,llc_miss,ia_modelo,ia_medida,energia_j\n");
+
+  for (int a = optind; a < argc; ++a)
+  {
+    Operandos_t op;
+    Arena_t *arena;
+
+    op.n = atoi(argv[a]);
+    op.lda = ldaPadding(op.n, 1);
+
+    srandom(20232);
+
+    arena = criaArena(3 * tamMatRow(op.n, op.lda) + 2 * tamVetor(op.n));
+    op.A = geraMatRow(arena, op.n, op.n, op.lda, 0);
+    op.B = geraMatRow(arena, op.n, op.n, op.lda, 0);
+    op.C = geraMatRow(arena, op.n, op.n, op.lda, 1);
+    op.v = geraVetor(arena, op.n, 0);
+    op.res = geraVetor(arena, op.n, 1);
+
+    if (!tempos || !op.A || !op.B || !op.C || !op.v || !op.res)
+    {
+      fprintf(stderr, "Falha em alocação de memória !!\n");
+      liberaArena(arena);
+      exit(2);
+    }
+
+    for (kernel_t k = 0; k < NUM_KERNELS; ++k)
+    {
+      long long soma[NUM_EVENTOS] = {0}, valores[NUM_EVENTOS];
+      double energia = 0.0;
+      rtime_t min, mediana, icInf, icSup;
+
+      fprintf(stderr, "--->>  %s: n = %d\n", nomeKernel[k], op.n);
+
+      for (int w = 0; w < aquecimento; ++w)
+      {
+        zeraSaida(k, &op);
+        executaKernel(k, &op);
+      }
+
+      for (int r = 0; r < repeticoes; ++r)
+      {
+        zeraSaida(k, &op);
+
+        iniciaContadores(&cont);
+        tempos[r] = timestamp();
+        executaKernel(k, &op);
+        tempos[r] = timestamp() - tempos[r];
+        paraContadores(&cont);
+
+        leContadores(&cont, valores);
+        for (int e = 0; e < NUM_EVENTOS; ++e)
+          soma[e] = (valores[e] < 0 || soma[e] < 0) ? -1 : soma[e] + valores[e];
+
+        double j = leEnergia(&cont);
+        energia = (j < 0.0 || energia < 0.0) ? -1.0 : energia + j;
+      }
+
+      estatisticas(tempos, repeticoes, &min, &mediana, &icInf, &icSup);
+
+      fprintf(saida, "%s,%d,%d,%.10lg,%.10lg,%.10lg,%.10lg,%.10lg", nomeKernel[k], op.n,
+              repeticoes, min, mediana, icInf, icSup,
+              flopsKernel(k, op.n) / (mediana * 1.0e3));
+      for (int e = 0; e < NUM_EVENTOS; ++e)
+        if (soma[e] < 0)
+          fprintf(saida, ",nan");
+        else
+          fprintf(saida, ",%.10lg", (double)soma[e] / repeticoes);
+
+      fprintf(saida, ",%.10lg", intensidadeAritmetica(k, op.n));
+      if (soma[evLLCMiss] > 0)
+        fprintf(saida, ",%.10lg", flopsKernel(k, op.n) * repeticoes / (64.0 * soma[evLLCMiss]));
+      else
+        fprintf(saida, ",nan");
+      if (energia >= 0.0)
+        fprintf(saida, ",%.10lg\n", energia / repeticoes);
+      else
+        fprintf(saida, ",nan\n");
+      fflush(saida);
+    }
+
+    liberaArena(arena);
+  }
+
+  fechaContadores(&cont);
+  free(tempos);
+  if (saida != stdout)
+    fclose(saida);
+
+  return 0;
+}
@@ -1,59 +1,60 @@
 #!/bin/bash
 
 PROG=matmult
+BENCH=benchmark
 CPU=3
 
 DATA_DIR="Dados/"
+TAMANHOS="64 100 128 1024 2000"
+REPETICOES=5
+AQUECIMENTO=1
 
 mkdir -p ${DATA_DIR}
 
-echo "performance" > /sys/devices/system/cpu/cpufreq/policy${CPU}/scaling_governor
-
-make purge matmult
+# Governador 'performance' apenas se houver permissão (não exige root)
+FREQUENCIA="/sys/devices/system/cpu/cpufreq/policy${CPU}/scaling_governor"
+if [ -w "${FREQUENCIA}" ]; then
+    echo "performance" > ${FREQUENCIA}
+fi
+
+make purge ${PROG} ${BENCH}
+
+# Tempos (mínimo, mediana, IC 95%) e contadores de hardware de todos os
+# kernels em um único CSV, consumido por 'plot_performance.gp'
+# Sondas de banda/FLOPS da máquina para o gráfico roofline ('roofline.gp')
+echo "--->>  ./${BENCH} ${TAMANHOS}" >/dev/tty
+taskset -c ${CPU} ./${BENCH} -r ${REPETICOES} -w ${AQUECIMENTO} \
+        -o ${DATA_DIR}/benchmark.csv -R ${DATA_DIR}/maquina.csv ${TAMANHOS}
+
+# Efeito do padding anti-conflito de cache: n = 1024 (lda potência de 2)
+# contra n = 1025, com e sem padding. Coluna final: 1 = com padding
+PADDING="${DATA_DIR}/Padding.csv"
+rm -f ${PADDING}
+for n in 1024 1025
+do
+    echo "--->>  Padding: ./${PROG} $n" >/dev/tty
+    echo "$(taskset -c ${CPU} ./${PROG} ${n}),1" >> ${PADDING}
+    echo "$(taskset -c ${CPU} ./${PROG} -u ${n}),0" >> ${PADDING}
+done
 
-METRICA="FLOPS_DP L3CACHE ENERGY"
-TAMANHOS="64 100 128 1024 2000"
-TEMPOS="${DATA_DIR}/Tempos.csv"
+# Ponto de cruzamento entre multMatMat_otim e Strassen-Winograd
+STRASSEN="${DATA_DIR}/Strassen.csv"
+rm -f ${STRASSEN}
+for n in 1024 2000 4096
+do
+    echo "--->>  Strassen: ./${PROG} -x $n" >/dev/tty
+    taskset -c ${CPU} ./${PROG} -x ${n} >> ${STRASSEN}
+done
 
-for m in ${METRICA}
+# Vazão (matrizes/s) do modo lote para matrizes pequenas
+LOTE="${DATA_DIR}/Lote.csv"
+rm -f ${LOTE}
+for m in 4 8 16 32
 do
-    LIKWID_CSV="${DATA_DIR}/${m}.csv"
-    rm -f ${TEMPOS}
-    rm -f ${LIKWID_CSV}
-
-    for n in $TAMANHOS
-    do
-        LIKWID_OUT="${DATA_DIR}/${m}_${n}.txt"
-        
-        echo "--->>  $m: ./${PROG} $n" >/dev/tty
-        # Executa com LIKWID
-        likwid-perfctr -O -C ${CPU} -g ${m} -o ${LIKWID_OUT} -m ./${PROG} ${n} >> ${TEMPOS}
-    done
-
-    # Define o nome da métrica a ser procurada com base no grupo
-    case "$m" in
-        "FLOPS_DP")
-            VARIAVEL="FP_ARITH_INST_RETIRED_SCALAR_DOUBLE"
-            POS=3
-        ;;
-        "L3CACHE")
-            VARIAVEL="L3 miss ratio"
-            POS=2
-        ;;
-        "ENERGY")
-            VARIAVEL="Energy \[J\]"
-            POS=2
-        ;;
-    esac
-
-    LIKWID_CSV="${DATA_DIR}/${m}.csv"
-
-    for n in $TAMANHOS
-    do
-        LIKWID_OUT="${DATA_DIR}/${m}_${n}.txt"
-        # Escreve linha no CSV
-        echo "${n},$(grep -E "${VARIAVEL}" ${LIKWID_OUT} | cut -d ',' -f${POS} | xargs | tr ' ' ',')" >> ${LIKWID_CSV}
-    done
+    echo "--->>  Lote: ./${PROG} -b $m 100000" >/dev/tty
+    ./${PROG} -b ${m} 100000 >> ${LOTE}
 done
 
-echo "powersave" > /sys/devices/system/cpu/cpufreq/policy${CPU}/scaling_governor
\ No newline at end of file
+if [ -w "${FREQUENCIA}" ]; then
+    echo "powersave" > ${FREQUENCIA}
+fi
\ No newline at end of file
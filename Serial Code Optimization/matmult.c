@@ -7,6 +7,7 @@
 
 #include "matriz.h"
 #include "utils.h"
+#include "roofline.h"
 
 /**
  * Exibe mensagem de erro indicando forma de uso do programa e termina
@@ -15,31 +16,202 @@
 
 static void usage(char *progname)
 {
-  fprintf(stderr, "Forma de uso: %s [ <ordem> ] \n", progname);
+  fprintf(stderr, "Forma de uso: %s [ -s <corte> ] [ -x ] [ -u ] [ -R ] <ordem> \n", progname);
+  fprintf(stderr, "              %s -b <ordem_pequena> <num_matrizes> \n", progname);
   exit(1);
 }
 
+/**
+ * Mede o ponto de cruzamento entre 'multMatMat_otim()' e Strassen-Winograd
+ * para vários valores de corte da recursão. Imprime uma linha CSV por corte:
+ *   <ordem>,<corte>,<tempo_otim>,<tempo_strassen>,<erro_relativo>
+ */
+static void crossover(MatRow A, MatRow B, int n, int lda)
+{
+  static const int cortes[] = {16, 32, 64, 128, 256, 512};
+  MatRow Cref = geraMatRow(NULL, n, n, lda, 1);
+  MatRow C = geraMatRow(NULL, n, n, lda, 1);
+  rtime_t tempo_otim, tempo;
+
+  if (!Cref || !C)
+  {
+    fprintf(stderr, "Falha em alocação de memória !!\n");
+    liberaVetor((void *)Cref);
+    liberaVetor((void *)C);
+    return;
+  }
+
+  tempo_otim = timestamp();
+  multMatMat_otim(A, B, n, lda, Cref);
+  tempo_otim = timestamp() - tempo_otim;
+
+  for (int c = 0; c < sizeof(cortes) / sizeof(cortes[0]) && cortes[c] < n; ++c)
+  {
+    real_t *arena = (real_t *)malloc(tamArenaStrassen(n, cortes[c]) * sizeof(real_t) + sizeof(real_t));
+    if (!arena)
+      break;
+
+    tempo = timestamp();
+    multMatMat_strassen(A, B, n, lda, C, cortes[c], arena);
+    tempo = timestamp() - tempo;
+
+    printf("%d,%d,%.10lg,%.10lg,%.10lg\n", n, cortes[c], tempo_otim, tempo,
+           erroRelMat(C, Cref, n, lda));
+    free(arena);
+  }
+
+  liberaVetor((void *)Cref);
+  liberaVetor((void *)C);
+}
+
+/**
+ * Relatório roofline: mede banda e pico da máquina e, para cada kernel,
+ * imprime uma linha CSV
+ *   roofline,<kernel>,<ordem>,<ia>,<gflops>,<teto_gflops>,<fracao_teto>,<cabe_llc>
+ * onde 'ia' é a intensidade aritmética do modelo de 'roofline.c'.
+ * O modelo conta apenas tráfego com a memória principal: se os dados do
+ * kernel cabem na LLC ('cabe_llc' = 1), o teto não se aplica e
+ * 'fracao_teto' pode passar de 1; um aviso é emitido em stderr.
+ */
+static void relatorioRoofline(int n, rtime_t tempos[NUM_KERNELS])
+{
+  Maquina_t maq;
+
+  mediMaquina(&maq);
+  printf("maquina,%.10lg,%.10lg\n", maq.banda, maq.pico);
+
+  for (kernel_t k = 0; k < NUM_KERNELS; ++k)
+  {
+    double ia = intensidadeAritmetica(k, n);
+    double gflops = flopsKernel(k, n) / (tempos[k] * 1.0e6);
+    double teto = tetoRoofline(&maq, ia);
+
+    int cabeLLC = maq.llc > 0 && bytesTrabalho(k, n) <= maq.llc;
+
+    printf("roofline,%s,%d,%.10lg,%.10lg,%.10lg,%.10lg,%d\n", nomeKernel[k], n,
+           ia, gflops, teto, gflops / teto, cabeLLC);
+    if (cabeLLC)
+      fprintf(stderr, "AVISO: %s, n = %d: dados (%.0f KB) cabem na LLC (%ld KB); "
+              "teto de memória principal não se aplica\n", nomeKernel[k], n,
+              bytesTrabalho(k, n) / 1024.0, maq.llc / 1024);
+  }
+}
+
+/**
+ * Multiplica lote de 'nLote' pares de matrizes 'm x m' com 'multMatMatLote()'
+ * e com um laço de chamadas a 'multMatMat_otim()'. Imprime linha CSV:
+ *   <m>,<nLote>,<tempo_lote>,<matrizes/s_lote>,<tempo_laco>,<matrizes/s_laco>
+ */
+static void modoLote(int m, int nLote)
+{
+  int stride = ldaPadding(m * m, 0);
+  Arena_t *arena = criaArena(4 * tamMatRow(nLote, stride));
+  MatRow A = geraMatRow(arena, nLote, m * m, stride, 0);
+  MatRow B = geraMatRow(arena, nLote, m * m, stride, 0);
+  MatRow C = geraMatRow(arena, nLote, m * m, stride, 1);
+  MatRow Cref = geraMatRow(arena, nLote, m * m, stride, 1);
+  rtime_t tempo, tempo_laco;
+
+  if (!A || !B || !C || !Cref)
+  {
+    fprintf(stderr, "Falha em alocação de memória !!\n");
+    liberaArena(arena);
+    exit(2);
+  }
+
+  LIKWID_MARKER_START("matMat_lote");
+  tempo = timestamp();
+  multMatMatLote(A, stride, B, stride, C, stride, m, nLote);
+  tempo = timestamp() - tempo;
+  LIKWID_MARKER_STOP("matMat_lote");
+
+  LIKWID_MARKER_START("matMat_laco");
+  tempo_laco = timestamp();
+  for (int l = 0; l < nLote; ++l)
+    multMatMat_otim(A + l * stride, B + l * stride, m, m, Cref + l * stride);
+  tempo_laco = timestamp() - tempo_laco;
+  LIKWID_MARKER_STOP("matMat_laco");
+
+  for (int l = 0; l < nLote; ++l)
+    if (erroRelMat(C + l * stride, Cref + l * stride, m, m) > 1.0e-12)
+    {
+      fprintf(stderr, "AVISO: resultados do lote divergem de multMatMat_otim()\n");
+      break;
+    }
+
+  printf("%d,%d,%.10lg,%.10lg,%.10lg,%.10lg\n", m, nLote,
+         tempo, nLote / (tempo * 1.0e-3), tempo_laco, nLote / (tempo_laco * 1.0e-3));
+
+  liberaArena(arena);
+}
+
 /**
  * Programa principal
- * Forma de uso: matmult [ -n <ordem> ]
- * -n <ordem>: ordem da matriz quadrada e dos vetores
+ * Forma de uso: matmult [ -s <corte> ] [ -x ] [ -u ] <ordem>
+ * <ordem>: ordem da matriz quadrada e dos vetores
+ * -s <corte>: também executa Strassen-Winograd com recursão até blocos
+ *             de ordem <corte>; acrescenta à linha CSV o tempo e o erro
+ *             relativo em relação a 'multMatMat_otim()'
+ * -x: apenas mede o ponto de cruzamento entre 'multMatMat_otim()' e
+ *     Strassen-Winograd para vários cortes
+ * -u: não acrescenta padding anti-conflito de cache às linhas das
+ *     matrizes quando 'lda' é potência de 2 (compare 1024 com 1025)
+ * -R: após a linha de tempos, imprime relatório roofline de cada kernel
+ *     (ver 'relatorioRoofline()')
+ *
+ * Forma de uso: matmult -b <m> <num_matrizes>
+ * -b <m>: modo lote; multiplica <num_matrizes> pares de matrizes 'm x m'
+ *         e informa a vazão em matrizes/segundo
  *
  */
 
 int main(int argc, char *argv[])
 {
   int n = DEF_SIZE;
+  int corte = 0, modoCrossover = 0, antiConflito = 1, ordemLote = 0, roofline = 0, opt;
+  int lda;
 
-  MatRow mRow_1, mRow_2, resMat, resMat_otim;
+  Arena_t *arena;
+  MatRow mRow_1, mRow_2, resMat, resMat_otim, resMat_str = NULL;
   Vetor vet, res, res_otim;
-  rtime_t tempo;
+  real_t *arenaStrassen = NULL;
+  rtime_t tempo, tempos[NUM_KERNELS];
 
   /* =============== TRATAMENTO DE LINHA DE COMANDO =============== */
 
-  if (argc < 2)
+  while ((opt = getopt(argc, argv, "s:xub:R")) != -1)
+  {
+    switch (opt)
+    {
+    case 's':
+      corte = atoi(optarg);
+      if (corte < 1)
+        usage(argv[0]);
+      break;
+    case 'x':
+      modoCrossover = 1;
+      break;
+    case 'u':
+      antiConflito = 0;
+      break;
+    case 'R':
+      roofline = 1;
+      break;
+    case 'b':
+      ordemLote = atoi(optarg);
+      if (ordemLote < 1)
+        usage(argv[0]);
+      break;
+    default:
+      usage(argv[0]);
+    }
+  }
+
+  if (optind >= argc)
     usage(argv[0]);
 
-  n = atoi(argv[1]);
+  n = atoi(argv[optind]);
+  lda = ldaPadding(n, antiConflito);
 
   /* ================ FIM DO TRATAMENTO DE LINHA DE COMANDO ========= */
 
@@ -47,32 +219,47 @@ int main(int argc, char *argv[])
 
   srandom(20232);
 
-  res = geraVetor(n, 0);
-  res_otim = geraVetor(n, 0);
-  resMat = geraMatRow(n, n, 1);
-  resMat_otim = geraMatRow(n, n, 1);
-
-  mRow_1 = geraMatRow(n, n, 0);
-  mRow_2 = geraMatRow(n, n, 0);
-
-  vet = geraVetor(n, 0);
+  if (ordemLote)
+  {
+    modoLote(ordemLote, n);
+    LIKWID_MARKER_CLOSE;
+    return 0;
+  }
 
-  if (!res || !res_otim || !resMat || !resMat_otim || !mRow_1 || !mRow_2 || !vet)
+  // Todas as matrizes e vetores vêm de uma única arena alinhada
+  arena = criaArena(4 * tamMatRow(n, lda) + 3 * tamVetor(n) +
+                    (corte > 0 ? tamMatRow(n, lda) + tamArenaStrassen(n, corte) * sizeof(real_t) : 0));
+  if (!arena)
   {
     fprintf(stderr, "Falha em alocação de memória !!\n");
-    liberaVetor((void *)mRow_1);
-    liberaVetor((void *)mRow_2);
-    liberaVetor((void *)resMat);
-    liberaVetor((void *)resMat_otim);
-    liberaVetor((void *)vet);
-    liberaVetor((void *)res);
-    liberaVetor((void *)res_otim);
     exit(2);
   }
 
+  res = geraVetor(arena, n, 0);
+  res_otim = geraVetor(arena, n, 0);
+  resMat = geraMatRow(arena, n, n, lda, 1);
+  resMat_otim = geraMatRow(arena, n, n, lda, 1);
+
+  mRow_1 = geraMatRow(arena, n, n, lda, 0);
+  mRow_2 = geraMatRow(arena, n, n, lda, 0);
+
+  vet = geraVetor(arena, n, 0);
+
+  if (corte > 0)
+  {
+    resMat_str = geraMatRow(arena, n, n, lda, 1);
+    arenaStrassen = (real_t *)arenaAloca(arena, tamArenaStrassen(n, corte) * sizeof(real_t));
+  }
+
+  if (modoCrossover)
+  {
+    crossover(mRow_1, mRow_2, n, lda);
+    goto fim;
+  }
+
 #ifdef _DEBUG_
-  prnMat(mRow_1, n, n);
-  prnMat(mRow_2, n, n);
+  prnMat(mRow_1, n, n, lda);
+  prnMat(mRow_2, n, n, lda);
   prnVetor(vet, n);
   printf("=================================\n\n");
 #endif /* _DEBUG_ */
@@ -80,47 +267,61 @@ int main(int argc, char *argv[])
   // Multiplicação Matriz-Vetor
   LIKWID_MARKER_START("matVet");
   tempo = timestamp();
-  multMatVet(mRow_1, vet, n, n, res);
+  multMatVet(mRow_1, vet, n, n, lda, res);
   tempo = timestamp() - tempo;
   LIKWID_MARKER_STOP("matVet");
   printf("%d,%.10lg,", n, tempo);
+  tempos[kMatVet] = tempo;
 
   // Multiplicação Matriz-Vetor Otimizada
   LIKWID_MARKER_START("matVet_otim");
   tempo = timestamp();
-  multMatVet_otim(mRow_1, vet, n, n, res_otim);
+  multMatVet_otim(mRow_1, vet, n, n, lda, res_otim);
   tempo = timestamp() - tempo;
   LIKWID_MARKER_STOP("matVet_otim");
   printf("%.10lg,", tempo);
+  tempos[kMatVetOtim] = tempo;
 
   // Multiplicação Matriz-Matriz
   LIKWID_MARKER_START("matMat");
   tempo = timestamp();
-  multMatMat(mRow_1, mRow_2, n, resMat);
+  multMatMat(mRow_1, mRow_2, n, lda, resMat);
   tempo = timestamp() - tempo;
   LIKWID_MARKER_STOP("matMat");
   printf("%.10lg,", tempo);
+  tempos[kMatMat] = tempo;
 
   // Multiplicação Matriz-Matriz Otimizada
   LIKWID_MARKER_START("matMat_otim");
   tempo = timestamp();
-  multMatMat_otim(mRow_1, mRow_2, n, resMat_otim);
+  multMatMat_otim(mRow_1, mRow_2, n, lda, resMat_otim);
   tempo = timestamp() - tempo;
   LIKWID_MARKER_STOP("matMat_otim");
-  printf("%.10lg\n", tempo);
+  printf("%.10lg", tempo);
+  tempos[kMatMatOtim] = tempo;
+
+  // Multiplicação Matriz-Matriz por Strassen-Winograd
+  if (corte > 0)
+  {
+    LIKWID_MARKER_START("matMat_strassen");
+    tempo = timestamp();
+    multMatMat_strassen(mRow_1, mRow_2, n, lda, resMat_str, corte, arenaStrassen);
+    tempo = timestamp() - tempo;
+    LIKWID_MARKER_STOP("matMat_strassen");
+    printf(",%.10lg,%.10lg", tempo, erroRelMat(resMat_str, resMat_otim, n, lda));
+  }
+  printf("\n");
+
+  if (roofline)
+    relatorioRoofline(n, tempos);
 
 #ifdef _DEBUG_
   prnVetor(res, n);
-  prnMat(resMat, n, n);
+  prnMat(resMat, n, n, lda);
 #endif /* _DEBUG_ */
 
-  liberaVetor((void *)mRow_1);
-  liberaVetor((void *)mRow_2);
-  liberaVetor((void *)resMat);
-  liberaVetor((void *)resMat_otim);
-  liberaVetor((void *)vet);
-  liberaVetor((void *)res);
-  liberaVetor((void *)res_otim);
+fim:
+  liberaArena(arena);
 
   LIKWID_MARKER_CLOSE;
 
@@ -3,6 +3,7 @@
 #include <math.h>
 #include <string.h> // Para uso de função 'memset()'
 
+#include "utils.h"
 #include "matriz.h"
 
 /**
@@ -27,39 +28,146 @@ static inline real_t generateRandomB()
   return (real_t)(BASE << 2) * (real_t)random() * invRandMax;
 }
 
+/* ----------- ARENA ---------------- */
+
+/**
+ *  Funcao criaArena: reserva área de 'tam' bytes, alinhada em ALINHAMENTO
+ *  bytes, da qual 'arenaAloca()' entrega blocos sem novas chamadas a malloc.
+ *
+ *  @param tam tamanho total em bytes
+ *  @return ponteiro para a arena, ou NULL em caso de falha de alocação
+ */
+Arena_t *criaArena(size_t tam)
+{
+  Arena_t *arena = (Arena_t *)malloc(sizeof(Arena_t));
+
+  if (arena)
+  {
+    arena->tam = (tam + ALINHAMENTO - 1) & ~(size_t)(ALINHAMENTO - 1);
+    arena->usado = 0;
+    if (posix_memalign((void **)&arena->mem, ALINHAMENTO, arena->tam ? arena->tam : ALINHAMENTO))
+    {
+      free(arena);
+      arena = NULL;
+    }
+  }
+
+  return arena;
+}
+
+/**
+ *  Funcao arenaAloca: entrega bloco de 'tam' bytes da arena, alinhado
+ *  em ALINHAMENTO bytes.
+ *  @return ponteiro para o bloco, ou NULL se a arena não tem espaço
+ */
+void *arenaAloca(Arena_t *arena, size_t tam)
+{
+  tam = (tam + ALINHAMENTO - 1) & ~(size_t)(ALINHAMENTO - 1);
+
+  if (!arena || arena->usado + tam > arena->tam)
+    return NULL;
+
+  void *bloco = arena->mem + arena->usado;
+  arena->usado += tam;
+
+  return bloco;
+}
+
+/* Libera a arena e todos os blocos entregues por ela */
+void liberaArena(Arena_t *arena)
+{
+  if (arena)
+  {
+    free(arena->mem);
+    free(arena);
+  }
+}
+
+/**
+ *  Funcao ldaPadding: 'leading dimension' para matrizes com 'n' colunas.
+ *  Arredonda 'n' para múltiplo de uma linha de cache (ALINHAMENTO bytes), de
+ *  modo que toda linha da matriz comece alinhada. Se 'antiConflito' e
+ *  o resultado é potência de 2, acrescenta uma linha de cache: com 'lda'
+ *  potência de 2 os elementos de uma mesma coluna caem nos mesmos
+ *  conjuntos da cache.
+ */
+int ldaPadding(int n, int antiConflito)
+{
+  const int porLinha = ALINHAMENTO / sizeof(real_t);
+  int lda = (n + porLinha - 1) / porLinha * porLinha;
+
+  if (antiConflito && isPot2(lda))
+    lda += porLinha;
+
+  return lda;
+}
+
+/* Tamanho em bytes de matriz 'm x lda' entregue por 'geraMatRow()' */
+size_t tamMatRow(int m, int lda)
+{
+  return ((size_t)m * lda * sizeof(real_t) + ALINHAMENTO - 1) & ~(size_t)(ALINHAMENTO - 1);
+}
+
+/* Tamanho em bytes de vetor de 'n' elementos entregue por 'geraVetor()' */
+size_t tamVetor(int n)
+{
+  return tamMatRow(1, ldaPadding(n, 0));
+}
+
+/* Aloca 'tam' bytes alinhados, da arena ou (se arena == NULL) do heap */
+static void *alocaAlinhado(Arena_t *arena, size_t tam)
+{
+  void *mem = NULL;
+
+  if (arena)
+    mem = arenaAloca(arena, tam);
+  else if (posix_memalign(&mem, ALINHAMENTO, tam))
+    mem = NULL;
+
+  return mem;
+}
+
 /* ----------- FUNÇÕES ---------------- */
 
 /**
- *  Funcao geraMatRow: gera matriz como vetor único, 'row-oriented'
+ *  Funcao geraMatRow: gera matriz como vetor único, 'row-oriented',
+ *  alinhada em ALINHAMENTO bytes. As colunas de padding (n <= j < lda)
+ *  são sempre nulas.
  *
+ *  @param arena arena de onde a matriz é alocada. Se NULL, a matriz
+ *               é alocada do heap e deve ser liberada com 'liberaVetor()'
  *  @param m     número de linhas da matriz
  *  @param n     número de colunas da matriz
+ *  @param lda   distância entre linhas ('leading dimension'), lda >= n.
+ *               Ver 'ldaPadding()'
  *  @param zerar se 0, matriz  tem valores aleatórios, caso contrário,
  *               matriz tem valores todos nulos
  *  @return  ponteiro para a matriz gerada
  *
  */
 
-MatRow geraMatRow(int m, int n, int zerar)
+MatRow geraMatRow(Arena_t *arena, int m, int n, int lda, int zerar)
 {
-  MatRow matriz = (real_t *)malloc(m * n * sizeof(real_t));
+  MatRow matriz = (real_t *)alocaAlinhado(arena, tamMatRow(m, lda));
 
   if (matriz)
   {
-    if (zerar)
-      memset(matriz, 0, m * n * sizeof(real_t));
-    else
+    memset(matriz, 0, (size_t)m * lda * sizeof(real_t));
+    if (!zerar)
       for (int i = 0; i < m; ++i)
         for (int j = 0; j < n; ++j)
-          matriz[i * n + j] = generateRandomA(i, j);
+          matriz[i * lda + j] = generateRandomA(i, j);
   }
 
   return (matriz);
 }
 
 /**
- *  Funcao geraVetor: gera vetor de tamanho 'n'
+ *  Funcao geraVetor: gera vetor de tamanho 'n', alinhado em ALINHAMENTO
+ *  bytes
  *
+ *  @param arena arena de onde o vetor é alocado. Se NULL, o vetor
+ *               é alocado do heap e deve ser liberado com 'liberaVetor()'
  *  @param n  número de elementos do vetor
  *  @param zerar se 0, vetor  tem valores aleatórios, caso contrário,
  *               vetor tem valores todos nulos
@@ -67,9 +175,9 @@ MatRow geraMatRow(int m, int n, int zerar)
  *
  */
 
-Vetor geraVetor(int n, int zerar)
+Vetor geraVetor(Arena_t *arena, int n, int zerar)
 {
-  Vetor vetor = (real_t *)malloc(n * sizeof(real_t));
+  Vetor vetor = (real_t *)alocaAlinhado(arena, tamVetor(n));
 
   if (vetor)
   {
@@ -84,7 +192,7 @@ Vetor geraVetor(int n, int zerar)
 }
 
 /**
- *  \brief: libera vetor
+ *  \brief: libera vetor alocado fora de arena
  *
  *  @param  ponteiro para vetor
  *
@@ -100,13 +208,14 @@ void liberaVetor(void *vet)
  *  @param mat matriz 'mxn'
  *  @param m número de linhas da matriz
  *  @param n número de colunas da matriz
+ *  @param lda distância entre linhas da matriz
  *  @param res vetor que guarda o resultado. Deve estar previamente alocado e com
  *             seus elementos inicializados em 0.0 (zero)
  *  @return vetor de 'm' elementos
  *
  */
 
-void multMatVet(MatRow mat, Vetor v, int m, int n, Vetor res)
+void multMatVet(MatRow mat, Vetor v, int m, int n, int lda, Vetor res)
 {
 
   /* Efetua a multiplicação */
@@ -114,7 +223,7 @@ void multMatVet(MatRow mat, Vetor v, int m, int n, Vetor res)
   {
     for (int i = 0; i < m; ++i)
       for (int j = 0; j < n; ++j)
-        res[i] += mat[n * i + j] * v[j];
+        res[i] += mat[lda * i + j] * v[j];
   }
 }
 
@@ -122,14 +231,14 @@ void multMatVet(MatRow mat, Vetor v, int m, int n, Vetor res)
  *  Funcao multMatVet_otim:  Versão otimizada da multiplicacao matriz-vetor
  *  Utiliza loop unrolling e melhor localidade de cache
  */
-void multMatVet_otim(MatRow mat, Vetor v, int m, int n, Vetor res)
+void multMatVet_otim(MatRow mat, Vetor v, int m, int n, int lda, Vetor res)
 {
   if (res)
   {
     for (int i = 0; i < m; ++i)
     {
       register real_t sum = 0.0;
-      register int pos = i * n;
+      register int pos = i * lda;
 
       // Loop unrolling por 4
       int j;
@@ -157,26 +266,27 @@ void multMatVet_otim(MatRow mat, Vetor v, int m, int n, Vetor res)
  *  @param A matriz 'n x n'
  *  @param B matriz 'n x n'
  *  @param n ordem da matriz quadrada
+ *  @param lda distância entre linhas de A, B e C
  *  @param C   matriz que guarda o resultado. Deve ser previamente gerada com 'geraMatPtr()'
  *             e com seus elementos inicializados em 0.0 (zero)
  *
  */
 
-void multMatMat(MatRow A, MatRow B, int n, MatRow C)
+void multMatMat(MatRow A, MatRow B, int n, int lda, MatRow C)
 {
 
   /* Efetua a multiplicação */
   for (int i = 0; i < n; ++i)
     for (int j = 0; j < n; ++j)
       for (int k = 0; k < n; ++k)
-        C[i * n + j] += A[i * n + k] * B[k * n + j];
+        C[i * lda + j] += A[i * lda + k] * B[k * lda + j];
 }
 
 /**
  *  Funcao multMatMat_otim: Versão otimizada da multiplicacao matriz-matriz
  *  Utiliza blocking/tiling para melhor uso de cache
  */
-void multMatMat_otim(MatRow A, MatRow B, int n, MatRow C)
+void multMatMat_otim(MatRow A, MatRow B, int n, int lda, MatRow C)
 {
   const int BLOCK_SIZE = 64; // Tamanho do bloco otimizado para cache
 
@@ -197,12 +307,12 @@ void multMatMat_otim(MatRow A, MatRow B, int n, MatRow C)
         {
           for (int j = jj; j < j_max; ++j)
           {
-            register real_t sum = C[i * n + j];
+            register real_t sum = C[i * lda + j];
             for (int k = kk; k < k_max; ++k)
             {
-              sum += A[i * n + k] * B[k * n + j];
+              sum += A[i * lda + k] * B[k * lda + j];
             }
-            C[i * n + j] = sum;
+            C[i * lda + j] = sum;
           }
         }
       }
@@ -210,20 +320,328 @@ void multMatMat_otim(MatRow A, MatRow B, int n, MatRow C)
   }
 }
 
+/* ----------- STRASSEN-WINOGRAD ---------------- */
+
+/**
+ *  Funcao multBlocoLd: C = A*B para blocos 'n x n' armazenados com
+ *  'leading dimensions' distintas. Mesmo blocking de 'multMatMat_otim()',
+ *  usado como caso base da recursão de Strassen-Winograd.
+ *  O conteúdo anterior de C é sobrescrito.
+ */
+static void multBlocoLd(const real_t *A, int lda, const real_t *B, int ldb,
+                        real_t *C, int ldc, int n)
+{
+  const int BLOCK_SIZE = 64;
+
+  for (int i = 0; i < n; ++i)
+    memset(C + i * ldc, 0, n * sizeof(real_t));
+
+  for (int ii = 0; ii < n; ii += BLOCK_SIZE)
+  {
+    int i_max = (ii + BLOCK_SIZE < n) ? ii + BLOCK_SIZE : n;
+    for (int kk = 0; kk < n; kk += BLOCK_SIZE)
+    {
+      int k_max = (kk + BLOCK_SIZE < n) ? kk + BLOCK_SIZE : n;
+      for (int jj = 0; jj < n; jj += BLOCK_SIZE)
+      {
+        int j_max = (jj + BLOCK_SIZE < n) ? jj + BLOCK_SIZE : n;
+
+        // Ordem i-k-j: acesso sequencial às linhas de B e C
+        for (int i = ii; i < i_max; ++i)
+          for (int k = kk; k < k_max; ++k)
+          {
+            register real_t a = A[i * lda + k];
+            for (int j = jj; j < j_max; ++j)
+              C[i * ldc + j] += a * B[k * ldb + j];
+          }
+      }
+    }
+  }
+}
+
+/* Z = X + Y, blocos 'h x h' */
+static void somaBloco(const real_t *X, int ldx, const real_t *Y, int ldy,
+                      real_t *Z, int ldz, int h)
+{
+  for (int i = 0; i < h; ++i)
+    for (int j = 0; j < h; ++j)
+      Z[i * ldz + j] = X[i * ldx + j] + Y[i * ldy + j];
+}
+
+/* Z = X - Y, blocos 'h x h' */
+static void subBloco(const real_t *X, int ldx, const real_t *Y, int ldy,
+                     real_t *Z, int ldz, int h)
+{
+  for (int i = 0; i < h; ++i)
+    for (int j = 0; j < h; ++j)
+      Z[i * ldz + j] = X[i * ldx + j] - Y[i * ldy + j];
+}
+
+/**
+ *  Recursão de Strassen-Winograd (7 produtos, 15 somas) com o escalonamento
+ *  de Boyer, Dumas, Pernet e Zhou, que usa apenas dois blocos temporários
+ *  'X' e 'Y' por nível. Os temporários de todos os níveis vêm da arena
+ *  'tmp', alocada antes da recursão: nenhuma alocação ocorre aqui.
+ *
+ *  @param m ordem dos blocos; m = c * 2^k com c <= corte
+ *  @param tmp arena com pelo menos tamArenaStrassen() elementos livres
+ */
+static void strassenRec(const real_t *A, int lda, const real_t *B, int ldb,
+                        real_t *C, int ldc, int m, int corte, real_t *tmp)
+{
+  if (m <= corte)
+  {
+    multBlocoLd(A, lda, B, ldb, C, ldc, m);
+    return;
+  }
+
+  int h = m / 2;
+  real_t *X = tmp, *Y = tmp + h * h, *prox = tmp + 2 * h * h;
+
+  const real_t *A11 = A, *A12 = A + h, *A21 = A + h * lda, *A22 = A + h * lda + h;
+  const real_t *B11 = B, *B12 = B + h, *B21 = B + h * ldb, *B22 = B + h * ldb + h;
+  real_t *C11 = C, *C12 = C + h, *C21 = C + h * ldc, *C22 = C + h * ldc + h;
+
+  subBloco(A11, lda, A21, lda, X, h, h);                 // S3 = A11 - A21
+  subBloco(B22, ldb, B12, ldb, Y, h, h);                 // T3 = B22 - B12
+  strassenRec(X, h, Y, h, C21, ldc, h, corte, prox);     // P7 = S3 * T3
+  somaBloco(A21, lda, A22, lda, X, h, h);                // S1 = A21 + A22
+  subBloco(B12, ldb, B11, ldb, Y, h, h);                 // T1 = B12 - B11
+  strassenRec(X, h, Y, h, C22, ldc, h, corte, prox);     // P5 = S1 * T1
+  subBloco(X, h, A11, lda, X, h, h);                     // S2 = S1 - A11
+  subBloco(B22, ldb, Y, h, Y, h, h);                     // T2 = B22 - T1
+  strassenRec(X, h, Y, h, C12, ldc, h, corte, prox);     // P6 = S2 * T2
+  subBloco(A12, lda, X, h, X, h, h);                     // S4 = A12 - S2
+  strassenRec(X, h, B22, ldb, C11, ldc, h, corte, prox); // P3 = S4 * B22
+  strassenRec(A11, lda, B11, ldb, X, h, h, corte, prox); // P1 = A11 * B11
+  somaBloco(X, h, C12, ldc, C12, ldc, h);                // U2 = P1 + P6
+  somaBloco(C12, ldc, C21, ldc, C21, ldc, h);            // U3 = U2 + P7
+  somaBloco(C12, ldc, C22, ldc, C12, ldc, h);            // U4 = U2 + P5
+  somaBloco(C21, ldc, C22, ldc, C22, ldc, h);            // U7 = U3 + P5
+  somaBloco(C12, ldc, C11, ldc, C12, ldc, h);            // U5 = U4 + P3
+  subBloco(Y, h, B21, ldb, Y, h, h);                     // T4 = T2 - B21
+  strassenRec(A22, lda, Y, h, C11, ldc, h, corte, prox); // P4 = A22 * T4
+  subBloco(C21, ldc, C11, ldc, C21, ldc, h);             // U6 = U3 - P4
+  strassenRec(A12, lda, B21, ldb, C11, ldc, h, corte, prox); // P2 = A12 * B21
+  somaBloco(X, h, C11, ldc, C11, ldc, h);                // U1 = P1 + P2
+}
+
+/* Ordem 'm >= n' usada na recursão: m = c * 2^k, com c <= corte */
+static int ordemStrassen(int n, int corte, int *niveis)
+{
+  int k = 0;
+
+  while (((n + (1 << k) - 1) >> k) > corte)
+    ++k;
+
+  if (niveis)
+    *niveis = k;
+
+  return ((n + (1 << k) - 1) >> k) << k;
+}
+
+/**
+ *  Funcao tamArenaStrassen: número de elementos 'real_t' da arena de
+ *  trabalho usada por 'multMatMat_strassen()' para matrizes 'n x n'.
+ *  Inclui cópias com padding de A, B e C quando 'n' não é da forma c*2^k.
+ */
+size_t tamArenaStrassen(int n, int corte)
+{
+  int k, m = ordemStrassen(n, corte, &k);
+  size_t tam = (m != n) ? 3 * (size_t)m * m : 0;
+
+  for (int l = 1; l <= k; ++l)
+  {
+    size_t h = m >> l;
+    tam += 2 * h * h;
+  }
+
+  return tam;
+}
+
+/**
+ *  Funcao multMatMat_strassen: multiplicacao de duas matrizes 'n x n' pelo
+ *  algoritmo de Strassen-Winograd. A recursão desce até blocos de ordem
+ *  <= 'corte' e então usa o kernel com blocking de 'multMatMat_otim()'.
+ *  Se 'n' não é da forma c*2^k (c <= corte), as matrizes são completadas
+ *  com zeros na arena.
+ *
+ *  @param A matriz 'n x n'
+ *  @param B matriz 'n x n'
+ *  @param n ordem da matriz quadrada
+ *  @param lda distância entre linhas de A, B e C
+ *  @param C matriz que guarda o resultado (conteúdo anterior é sobrescrito)
+ *  @param corte ordem a partir da qual se usa o algoritmo clássico
+ *  @param arena área de trabalho com 'tamArenaStrassen(n, corte)' elementos.
+ *               Se NULL, é alocada (uma única vez) e liberada aqui.
+ *  @return 0 em caso de sucesso, -1 se falhar alocação da arena
+ */
+int multMatMat_strassen(MatRow A, MatRow B, int n, int lda, MatRow C, int corte, real_t *arena)
+{
+  real_t *mem = arena;
+
+  if (corte < 1)
+    corte = STRASSEN_CORTE;
+
+  int m = ordemStrassen(n, corte, NULL);
+
+  if (!mem)
+  {
+    mem = (real_t *)malloc(tamArenaStrassen(n, corte) * sizeof(real_t) + sizeof(real_t));
+    if (!mem)
+      return -1;
+  }
+
+  if (m == n)
+    strassenRec(A, lda, B, lda, C, lda, n, corte, mem);
+  else
+  {
+    real_t *Ap = mem, *Bp = mem + (size_t)m * m, *Cp = mem + 2 * (size_t)m * m;
+
+    memset(Ap, 0, 2 * (size_t)m * m * sizeof(real_t));
+    for (int i = 0; i < n; ++i)
+    {
+      memcpy(Ap + (size_t)i * m, A + (size_t)i * lda, n * sizeof(real_t));
+      memcpy(Bp + (size_t)i * m, B + (size_t)i * lda, n * sizeof(real_t));
+    }
+
+    strassenRec(Ap, m, Bp, m, Cp, m, m, corte, Cp + (size_t)m * m);
+
+    for (int i = 0; i < n; ++i)
+      memcpy(C + (size_t)i * lda, Cp + (size_t)i * m, n * sizeof(real_t));
+  }
+
+  if (!arena)
+    free(mem);
+
+  return 0;
+}
+
+/**
+ *  Funcao erroRelMat: erro relativo na norma do máximo entre matriz 'C'
+ *  e matriz de referência 'Cref', ambas 'n x n' com distância 'lda' entre
+ *  linhas:  max|C - Cref| / max|Cref|
+ *  Usada para medir o crescimento do erro de Strassen em relação ao
+ *  algoritmo clássico.
+ */
+real_t erroRelMat(MatRow C, MatRow Cref, int n, int lda)
+{
+  real_t maxDif = 0.0, maxRef = 0.0;
+
+  for (int i = 0; i < n; ++i)
+    for (int j = 0; j < n; ++j)
+    {
+      real_t d = ABS(C[i * lda + j] - Cref[i * lda + j]), r = ABS(Cref[i * lda + j]);
+      if (d > maxDif)
+        maxDif = d;
+      if (r > maxRef)
+        maxRef = r;
+    }
+
+  return (maxRef > 0.0) ? maxDif / maxRef : maxDif;
+}
+
+/* ----------- LOTES DE MATRIZES PEQUENAS ---------------- */
+
+/*
+ * Gera kernel especializado C = A*B para matrizes 'M x M' contíguas
+ * (lda = M). Com M constante em tempo de compilação o laço interno vira
+ * um número fixo de instruções SIMD e a linha de C fica em registradores.
+ */
+#define DEF_MULT_PEQ(M)                                                       \
+  static void multPeq_##M(const real_t *restrict A, const real_t *restrict B, \
+                          real_t *restrict C)                                 \
+  {                                                                           \
+    for (int i = 0; i < M; ++i)                                               \
+    {                                                                         \
+      real_t *restrict c = C + i * M;                                         \
+      _Pragma("omp simd")                                                     \
+      for (int j = 0; j < M; ++j)                                             \
+        c[j] = 0.0;                                                           \
+      for (int k = 0; k < M; ++k)                                             \
+      {                                                                       \
+        register real_t a = A[i * M + k];                                     \
+        _Pragma("omp simd")                                                   \
+        for (int j = 0; j < M; ++j)                                           \
+          c[j] += a * B[k * M + j];                                           \
+      }                                                                       \
+    }                                                                         \
+  }
+
+DEF_MULT_PEQ(4)
+DEF_MULT_PEQ(8)
+DEF_MULT_PEQ(16)
+DEF_MULT_PEQ(32)
+
+/* Kernel genérico C = A*B para matrizes 'm x m' contíguas */
+static void multPeq(const real_t *restrict A, const real_t *restrict B,
+                    real_t *restrict C, int m)
+{
+  for (int i = 0; i < m; ++i)
+    for (int j = 0; j < m; ++j)
+    {
+      register real_t sum = 0.0;
+      for (int k = 0; k < m; ++k)
+        sum += A[i * m + k] * B[k * m + j];
+      C[i * m + j] = sum;
+    }
+}
+
+/* Percorre o lote aplicando o kernel 'KERNEL(A, B, C)' a cada matriz */
+#define LACO_LOTE(KERNEL)                                                 \
+  _Pragma("omp parallel for schedule(static)")                            \
+  for (int l = 0; l < nLote; ++l)                                         \
+    KERNEL(A + l * strideA, B + l * strideB, C + l * strideC)
+
+#define KERNEL_GENERICO(a, b, c) multPeq(a, b, c, m)
+
+/**
+ *  Funcao multMatMatLote: multiplica lote de 'nLote' pares de matrizes
+ *  pequenas 'm x m':  C[l] = A[l] * B[l], 0 <= l < nLote.
+ *  Cada matriz é contígua ('row-oriented', lda = m); matrizes sucessivas
+ *  do lote estão a 'strideA', 'strideB' e 'strideC' elementos umas das
+ *  outras. Para m = 4, 8, 16 e 32 usa kernels especializados. O lote é
+ *  dividido entre as threads (OpenMP).
+ *
+ *  @param C lote de resultados (conteúdo anterior é sobrescrito)
+ */
+void multMatMatLote(const real_t *A, size_t strideA, const real_t *B, size_t strideB,
+                    real_t *C, size_t strideC, int m, int nLote)
+{
+  switch (m)
+  {
+  case 4:
+    LACO_LOTE(multPeq_4);
+    break;
+  case 8:
+    LACO_LOTE(multPeq_8);
+    break;
+  case 16:
+    LACO_LOTE(multPeq_16);
+    break;
+  case 32:
+    LACO_LOTE(multPeq_32);
+    break;
+  default:
+    LACO_LOTE(KERNEL_GENERICO);
+  }
+}
+
 /**
  *  Funcao prnMat:  Imprime o conteudo de uma matriz em stdout
  *  @param mat matriz
  *  @param m número de linhas da matriz
  *  @param n número de colunas da matriz
+ *  @param lda distância entre linhas da matriz
  *
  */
 
-void prnMat(MatRow mat, int m, int n)
+void prnMat(MatRow mat, int m, int n, int lda)
 {
   for (int i = 0; i < m; ++i)
   {
     for (int j = 0; j < n; ++j)
-      printf(DBL_FIELD, mat[n * i + j]);
+      printf(DBL_FIELD, mat[lda * i + j]);
     printf("\n");
   }
   printf(SEP_RES);
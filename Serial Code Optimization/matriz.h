@@ -6,6 +6,12 @@
 #define DEF_SIZE 128
 #define BASE 32
 
+// Alinhamento (bytes) de matrizes e vetores: uma linha de cache
+#define ALINHAMENTO 64
+
+// Ordem de bloco abaixo da qual Strassen usa o algoritmo clássico
+#define STRASSEN_CORTE 128
+
 
 #define ABS(num)  ((num) < 0.0 ? -(num) : (num))
 
@@ -16,18 +22,40 @@ typedef double real_t;
 typedef real_t * MatRow;
 typedef real_t * Vetor;
 
+// Arena: área única, alinhada, de onde são entregues matrizes e vetores
+typedef struct {
+  char *mem;     // área alocada, alinhada em ALINHAMENTO bytes
+  size_t tam;    // tamanho total (bytes)
+  size_t usado;  // bytes já entregues
+} Arena_t;
+
 /* ----------- FUNÇÕES ---------------- */
 
-MatRow geraMatRow (int m, int n, int zerar);
-Vetor geraVetor (int n, int zerar);
+Arena_t *criaArena (size_t tam);
+void *arenaAloca (Arena_t *arena, size_t tam);
+void liberaArena (Arena_t *arena);
+
+int ldaPadding (int n, int antiConflito);
+size_t tamMatRow (int m, int lda);
+size_t tamVetor (int n);
+
+MatRow geraMatRow (Arena_t *arena, int m, int n, int lda, int zerar);
+Vetor geraVetor (Arena_t *arena, int n, int zerar);
 
 void liberaVetor (void *vet);
 
-void multMatVet (MatRow mat, Vetor v, int m, int n, Vetor res);
-void multMatVet_otim (MatRow mat, Vetor v, int m, int n, Vetor res);
-void multMatMat(MatRow A, MatRow B, int n, MatRow C);
-void multMatMat_otim(MatRow A, MatRow B, int n, MatRow C);
+void multMatVet (MatRow mat, Vetor v, int m, int n, int lda, Vetor res);
+void multMatVet_otim (MatRow mat, Vetor v, int m, int n, int lda, Vetor res);
+void multMatMat(MatRow A, MatRow B, int n, int lda, MatRow C);
+void multMatMat_otim(MatRow A, MatRow B, int n, int lda, MatRow C);
+
+size_t tamArenaStrassen(int n, int corte);
+int multMatMat_strassen(MatRow A, MatRow B, int n, int lda, MatRow C, int corte, real_t *arena);
+real_t erroRelMat(MatRow C, MatRow Cref, int n, int lda);
+
+void multMatMatLote(const real_t *A, size_t strideA, const real_t *B, size_t strideB,
+                    real_t *C, size_t strideC, int m, int nLote);
 
-void prnMat (MatRow mat, int m, int n);
+void prnMat (MatRow mat, int m, int n, int lda);
 void prnVetor (Vetor vet, int n);
 
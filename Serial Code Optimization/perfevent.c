@@ -0,0 +1,159 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#include "perfevent.h"
+
+/* Configuração perf_event de cada evento de 'eventoHW_t' */
+static const struct {
+  unsigned int tipo;
+  unsigned long long config;
+} eventos[NUM_EVENTOS] = {
+  {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+  {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+  {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                       (PERF_COUNT_HW_CACHE_RESULT_ACCESS << 16)},
+  {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                       (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+};
+
+/* Não há wrapper na libc para perf_event_open(2) */
+static int perfEventOpen(struct perf_event_attr *attr)
+{
+  return (int)syscall(SYS_perf_event_open, attr, 0, -1, -1, 0);
+}
+
+// Diretório da PMU de energia (RAPL) no sysfs
+#define PMU_ENERGIA "/sys/bus/event_source/devices/power/"
+
+/* Lê a primeira linha de 'PMU_ENERGIA/arq' em 'buf'. Retorna 0 se falhar */
+static int lePMUEnergia(const char *arq, char *buf, int tam)
+{
+  char caminho[256];
+  FILE *f;
+  int ok;
+
+  snprintf(caminho, sizeof(caminho), PMU_ENERGIA "%s", arq);
+  if (!(f = fopen(caminho, "r")))
+    return 0;
+  ok = (fgets(buf, tam, f) != NULL);
+  fclose(f);
+
+  return ok;
+}
+
+/* Abre o contador de energia do pacote (CPU 0). Retorna o descritor ou -1 */
+static int abreEnergia(double *escala)
+{
+  struct perf_event_attr attr;
+  char buf[64];
+  unsigned int tipo, config;
+
+  if (!lePMUEnergia("type", buf, sizeof(buf)) || sscanf(buf, "%u", &tipo) != 1 ||
+      !lePMUEnergia("events/energy-pkg", buf, sizeof(buf)) ||
+      sscanf(buf, "event=%x", &config) != 1 ||
+      !lePMUEnergia("events/energy-pkg.scale", buf, sizeof(buf)))
+    return -1;
+
+  *escala = atof(buf);
+
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = tipo;
+  attr.config = config;
+  attr.disabled = 1;
+
+  return (int)syscall(SYS_perf_event_open, &attr, -1, 0, -1, 0);
+}
+
+/* Abre os contadores. Retorna o número de eventos disponíveis */
+int abreContadores(ContadoresHW_t *c)
+{
+  int disponiveis = 0;
+
+  for (int e = 0; e < NUM_EVENTOS; ++e)
+  {
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = eventos[e].tipo;
+    attr.config = eventos[e].config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    c->fd[e] = perfEventOpen(&attr);
+    if (c->fd[e] >= 0)
+      ++disponiveis;
+  }
+
+  c->fdEnergia = abreEnergia(&c->escalaEnergia);
+
+  return disponiveis;
+}
+
+void fechaContadores(ContadoresHW_t *c)
+{
+  for (int e = 0; e < NUM_EVENTOS; ++e)
+    if (c->fd[e] >= 0)
+    {
+      close(c->fd[e]);
+      c->fd[e] = -1;
+    }
+  if (c->fdEnergia >= 0)
+  {
+    close(c->fdEnergia);
+    c->fdEnergia = -1;
+  }
+}
+
+/* Zera e inicia a contagem de todos os eventos disponíveis */
+void iniciaContadores(ContadoresHW_t *c)
+{
+  for (int e = 0; e < NUM_EVENTOS; ++e)
+    if (c->fd[e] >= 0)
+    {
+      ioctl(c->fd[e], PERF_EVENT_IOC_RESET, 0);
+      ioctl(c->fd[e], PERF_EVENT_IOC_ENABLE, 0);
+    }
+  if (c->fdEnergia >= 0)
+  {
+    ioctl(c->fdEnergia, PERF_EVENT_IOC_RESET, 0);
+    ioctl(c->fdEnergia, PERF_EVENT_IOC_ENABLE, 0);
+  }
+}
+
+void paraContadores(ContadoresHW_t *c)
+{
+  for (int e = 0; e < NUM_EVENTOS; ++e)
+    if (c->fd[e] >= 0)
+      ioctl(c->fd[e], PERF_EVENT_IOC_DISABLE, 0);
+  if (c->fdEnergia >= 0)
+    ioctl(c->fdEnergia, PERF_EVENT_IOC_DISABLE, 0);
+}
+
+/* Lê valores acumulados. Eventos indisponíveis retornam -1 */
+void leContadores(ContadoresHW_t *c, long long valores[NUM_EVENTOS])
+{
+  for (int e = 0; e < NUM_EVENTOS; ++e)
+  {
+    valores[e] = -1;
+    if (c->fd[e] >= 0 && read(c->fd[e], &valores[e], sizeof(long long)) != sizeof(long long))
+      valores[e] = -1;
+  }
+}
+
+double leEnergia(ContadoresHW_t *c)
+{
+  long long valor;
+
+  if (c->fdEnergia < 0 || read(c->fdEnergia, &valor, sizeof(valor)) != sizeof(valor))
+    return -1.0;
+
+  return valor * c->escalaEnergia;
+}
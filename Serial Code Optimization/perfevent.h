@@ -0,0 +1,41 @@
+#ifndef __PERFEVENT_H__
+#define __PERFEVENT_H__
+
+// Contadores de hardware lidos diretamente com perf_event_open(2).
+// Não dependem de LIKWID nem de root: contam apenas o próprio processo,
+// em modo usuário (basta /proc/sys/kernel/perf_event_paranoid <= 2).
+
+// Eventos medidos
+typedef enum {
+  evCiclos = 0,  // ciclos de CPU
+  evInstrucoes,  // instruções executadas
+  evLLCRef,      // acessos de leitura à cache de último nível (L3)
+  evLLCMiss,     // falhas de leitura na cache de último nível (L3)
+  NUM_EVENTOS
+} eventoHW_t;
+
+typedef struct {
+  int fd[NUM_EVENTOS];  // descritor de cada evento; -1 se indisponível
+  int fdEnergia;        // energia do pacote (RAPL, 'power/energy-pkg/'); -1 se indisponível
+  double escalaEnergia; // Joules por unidade do contador de energia
+} ContadoresHW_t;
+
+// Abre os contadores. Retorna o número de eventos disponíveis
+int abreContadores (ContadoresHW_t *c);
+void fechaContadores (ContadoresHW_t *c);
+
+// Zera e inicia / para a contagem de todos os eventos disponíveis
+void iniciaContadores (ContadoresHW_t *c);
+void paraContadores (ContadoresHW_t *c);
+
+// Lê valores acumulados. Eventos indisponíveis retornam -1
+void leContadores (ContadoresHW_t *c, long long valores[NUM_EVENTOS]);
+
+// Energia do pacote (RAPL) pela PMU 'power' do perf_event. Mede o pacote
+// inteiro (não só o processo), por isso exige perf_event_paranoid <= 0 ou
+// CAP_PERFMON; é aberta por 'abreContadores()' quando disponível e segue
+// 'iniciaContadores()'/'paraContadores()'.
+// Retorna a energia acumulada [J], ou -1.0 se indisponível
+double leEnergia (ContadoresHW_t *c);
+
+#endif // __PERFEVENT_H__
@@ -13,19 +13,23 @@ set logscale x
 
 set datafile separator comma
 
+# Todas as métricas vêm do CSV do harness 'benchmark' (ver plot_performance.gp):
+# uma linha por kernel e tamanho; 'sel()' filtra as linhas de cada kernel
+ARQ=ARG1."/benchmark.csv"
+sel(k,c) = (strcol(1) eq k) ? column(c) : NaN
+
 #
-# TEMPO
+# TEMPO (mediana)
 #
-ARQ=ARG1."/Tempos.csv"
 set key left top
 set logscale y
 set ylabel  "Tempo (ms)"
 set title   "Tempo"
 set terminal qt 0 title "Tempos"
-plot ARQ using 1:2 title "MatVet" lc rgb "green" with linespoints, \
-     '' using 1:3 title "MatVet-uj" lc rgb "red" with linespoints, \
-     '' using 1:4 title "MatMat" lc rgb "magenta" with linespoints, \
-     '' using 1:5 title "MatMat-uj" lc rgb "cyan" with linespoints
+plot ARQ every ::1 using 2:(sel("matVet",5)) title "MatVet" lc rgb "green" with linespoints, \
+     '' every ::1 using 2:(sel("matVet_otim",5)) title "MatVet-uj" lc rgb "red" with linespoints, \
+     '' every ::1 using 2:(sel("matMat",5)) title "MatMat" lc rgb "magenta" with linespoints, \
+     '' every ::1 using 2:(sel("matMat_otim",5)) title "MatMat-uj" lc rgb "cyan" with linespoints
 
 pause -1
 
@@ -35,48 +39,45 @@ set datafile separator comma
 #
 # FLOPS_DP
 #
-ARQ=ARG1."/FLOPS_DP.csv"
 set key right top
 unset logscale y
 set ylabel  "FLOPS DP [MFlops/s]"
 set title   "FLOPS DP"
 set terminal qt 1 title "FLOPS DP"
-plot ARQ using 1:2 title "MatVet" lc rgb "green" with linespoints, \
-     '' using 1:3 title "MatVet-uj" lc rgb "red" with linespoints, \
-     '' using 1:4 title "MatMat" lc rgb "magenta" with linespoints, \
-     '' using 1:5 title "MatMat-uj" lc rgb "cyan" with linespoints
+plot ARQ every ::1 using 2:(sel("matVet",8)) title "MatVet" lc rgb "green" with linespoints, \
+     '' every ::1 using 2:(sel("matVet_otim",8)) title "MatVet-uj" lc rgb "red" with linespoints, \
+     '' every ::1 using 2:(sel("matMat",8)) title "MatMat" lc rgb "magenta" with linespoints, \
+     '' every ::1 using 2:(sel("matMat_otim",8)) title "MatMat-uj" lc rgb "cyan" with linespoints
 
 pause -1
 
 #
-# ENERGY
+# ENERGY (RAPL 'power/energy-pkg/'; vazio se indisponível)
 #
-ARQ=ARG1."/ENERGY.csv"
 set key center top
 unset logscale y
 set ylabel  "Energia [J]"
 set title   "Energia"
 set terminal qt 2 title "Energia"
-plot ARQ using 1:2 title "MatVet" lc rgb "green" with linespoints, \
-     '' using 1:3 title "MatVet-uj" lc rgb "red" with linespoints, \
-     '' using 1:4 title "MatMat" lc rgb "magenta" with linespoints, \
-     '' using 1:5 title "MatMat-uj" lc rgb "cyan" with linespoints
+plot ARQ every ::1 using 2:(sel("matVet",15)) title "MatVet" lc rgb "green" with linespoints, \
+     '' every ::1 using 2:(sel("matVet_otim",15)) title "MatVet-uj" lc rgb "red" with linespoints, \
+     '' every ::1 using 2:(sel("matMat",15)) title "MatMat" lc rgb "magenta" with linespoints, \
+     '' every ::1 using 2:(sel("matMat_otim",15)) title "MatMat-uj" lc rgb "cyan" with linespoints
 
 pause -1
 
 #
 # L3CACHE
 #
-ARQ=ARG1."/L3CACHE.csv"
 set key left top
 unset logscale y
 set ylabel  "L3 miss ratio"
 set title   "L3 miss ratio"
 set terminal qt 3 title "L3 miss ratio"
-plot ARQ using 1:2 title "MatVet" lc rgb "green" with linespoints, \
-     '' using 1:3 title "MatVet-uj" lc rgb "red" with linespoints, \
-     '' using 1:4 title "MatMat" lc rgb "magenta" with linespoints, \
-     '' using 1:5 title "MatMat-uj" lc rgb "cyan" with linespoints
+plot ARQ every ::1 using 2:(sel("matVet",12)/sel("matVet",11)) title "MatVet" lc rgb "green" with linespoints, \
+     '' every ::1 using 2:(sel("matVet_otim",12)/sel("matVet_otim",11)) title "MatVet-uj" lc rgb "red" with linespoints, \
+     '' every ::1 using 2:(sel("matMat",12)/sel("matMat",11)) title "MatMat" lc rgb "magenta" with linespoints, \
+     '' every ::1 using 2:(sel("matMat_otim",12)/sel("matMat_otim",11)) title "MatMat-uj" lc rgb "cyan" with linespoints
 
 pause -1
 
@@ -1,50 +1,60 @@
 #!/usr/bin/gnuplot
 
-# Script para gerar gráficos de análise de desempenho
+# Script para gerar gráficos de análise de desempenho a partir do CSV
+# gerado pelo harness 'benchmark' (uma linha por kernel e tamanho):
+#   kernel,n,rep,min_ms,mediana_ms,ic95_inf_ms,ic95_sup_ms,mflops,
+#   ciclos,instrucoes,llc_ref,llc_miss,ia_modelo,ia_medida,energia_j
+
+ARQ = 'Dados/benchmark.csv'
+KERNELS = "matVet matVet_otim matMat matMat_otim"
 
 set terminal pngcairo size 1200,800
+set datafile separator comma
 set key outside right
 set grid
 set logscale x
 
-# Gráfico de Tempo
+# Seleciona coluna 'c' apenas nas linhas do kernel 'k'
+sel(k, c) = (strcol(1) eq k) ? column(c) : NaN
+
+# Gráfico de Tempo (mediana, com intervalo de confiança de 95%)
 set output 'Dados/grafico_tempo.png'
 set title 'Tempo de Execução vs Tamanho da Matriz'
 set xlabel 'Tamanho da Matriz (N)'
 set ylabel 'Tempo (ms)'
-plot 'Dados/Tempos.csv' using 1:2 with linespoints title 'matVet', \
-     'Dados/Tempos.csv' using 1:3 with linespoints title 'matVet_otim', \
-     'Dados/Tempos.csv' using 1:4 with linespoints title 'matMat', \
-     'Dados/Tempos.csv' using 1:5 with linespoints title 'matMat_otim'
+set logscale y
+plot for [k in KERNELS] ARQ every ::1 using 2:(sel(k,5)):(sel(k,6)):(sel(k,7)) \
+     with yerrorlines title k, \
+     for [k in KERNELS] ARQ every ::1 using 2:(sel(k,4)) \
+     with points pt 2 title k.' (min)'
+unset logscale y
+
+# Gráfico de FLOPS
+set output 'Dados/grafico_flops.png'
+set title 'Desempenho FLOPS vs Tamanho da Matriz'
+set xlabel 'Tamanho da Matriz (N)'
+set ylabel 'MFLOP/s'
+plot for [k in KERNELS] ARQ every ::1 using 2:(sel(k,8)) with linespoints title k
 
-# Gráfico de Cache Miss L3
+# Gráfico de Cache Miss L3 (contadores de hardware)
 set output 'Dados/grafico_l3cache.png'
 set title 'Taxa de Cache Miss L3 vs Tamanho da Matriz'
 set xlabel 'Tamanho da Matriz (N)'
 set ylabel 'L3 Miss Ratio'
-plot 'Dados/L3CACHE.csv' using 1:2 with linespoints title 'matVet', \
-     'Dados/L3CACHE.csv' using 1:3 with linespoints title 'matVet_otim', \
-     'Dados/L3CACHE.csv' using 1:4 with linespoints title 'matMat', \
-     'Dados/L3CACHE.csv' using 1:5 with linespoints title 'matMat_otim'
+plot for [k in KERNELS] ARQ every ::1 using 2:(sel(k,12)/sel(k,11)) with linespoints title k
 
-# Gráfico de Energia
+# Gráfico de Energia do pacote (RAPL; sem pontos se 'nan')
 set output 'Dados/grafico_energia.png'
 set title 'Consumo de Energia vs Tamanho da Matriz'
 set xlabel 'Tamanho da Matriz (N)'
 set ylabel 'Energia (J)'
-plot 'Dados/ENERGY.csv' using 1:2 with linespoints title 'matVet', \
-     'Dados/ENERGY.csv' using 1:3 with linespoints title 'matVet_otim', \
-     'Dados/ENERGY.csv' using 1:4 with linespoints title 'matMat', \
-     'Dados/ENERGY.csv' using 1:5 with linespoints title 'matMat_otim'
+plot for [k in KERNELS] ARQ every ::1 using 2:(sel(k,15)) with linespoints title k
 
-# Gráfico de FLOPS
-set output 'Dados/grafico_flops.png'
-set title 'Desempenho FLOPS vs Tamanho da Matriz'
+# Gráfico de instruções por ciclo (contadores de hardware)
+set output 'Dados/grafico_ipc.png'
+set title 'Instruções por Ciclo vs Tamanho da Matriz'
 set xlabel 'Tamanho da Matriz (N)'
-set ylabel 'MFLOP/s'
-plot 'Dados/FLOPS_DP.csv' using 1:2 with linespoints title 'matVet', \
-     'Dados/FLOPS_DP.csv' using 1:3 with linespoints title 'matVet_otim', \
-     'Dados/FLOPS_DP.csv' using 1:4 with linespoints title 'matMat', \
-     'Dados/FLOPS_DP.csv' using 1:5 with linespoints title 'matMat_otim'
+set ylabel 'IPC'
+plot for [k in KERNELS] ARQ every ::1 using 2:(sel(k,10)/sel(k,9)) with linespoints title k
 
-print "Gráficos gerados em Dados/"
\ No newline at end of file
+print "Gráficos gerados em Dados/"
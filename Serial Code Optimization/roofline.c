@@ -0,0 +1,199 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "utils.h"
+#include "roofline.h"
+
+// Elementos de cada vetor da sonda de banda: 3 x 64 MB, bem acima da L3
+#define SONDA_N (1 << 23)
+#define SONDA_REP 5
+
+// Acumuladores independentes da sonda de FMA: suficientes para esconder
+// a latência da FMA nas duas portas de execução, mesmo com AVX-512
+#define SONDA_ACC 64
+#define SONDA_ITER 20000000L
+
+// Tamanho do bloco usado por 'multMatMat_otim()'
+#define BLOCO_OTIM 64
+
+const char *nomeKernel[NUM_KERNELS] = {
+  "matVet", "matVet_otim", "matMat", "matMat_otim"
+};
+
+/**
+ * Sonda de banda de memória no estilo STREAM triad: a[i] = b[i] + s*c[i].
+ * Conta 24 bytes por elemento (sem write-allocate, como o STREAM).
+ * @return melhor banda observada [GB/s], ou 0.0 se falhar alocação
+ */
+double sondaBanda(void)
+{
+  real_t *a, *b, *c;
+  double melhor = 0.0;
+
+  if (posix_memalign((void **)&a, 64, SONDA_N * sizeof(real_t)))
+    return 0.0;
+  if (posix_memalign((void **)&b, 64, SONDA_N * sizeof(real_t)))
+  {
+    free(a);
+    return 0.0;
+  }
+  if (posix_memalign((void **)&c, 64, SONDA_N * sizeof(real_t)))
+  {
+    free(a);
+    free(b);
+    return 0.0;
+  }
+
+  for (int i = 0; i < SONDA_N; ++i)
+  {
+    a[i] = 0.0;
+    b[i] = 1.0;
+    c[i] = 2.0;
+  }
+
+  for (int r = 0; r < SONDA_REP; ++r)
+  {
+    const real_t s = 3.0;
+    rtime_t tempo = timestamp();
+    for (int i = 0; i < SONDA_N; ++i)
+      a[i] = b[i] + s * c[i];
+    tempo = timestamp() - tempo;
+
+    double banda = 3.0 * SONDA_N * sizeof(real_t) / (tempo * 1.0e6);
+    if (banda > melhor)
+      melhor = banda;
+  }
+
+  // Impede que o compilador elimine o laço
+  if (a[SONDA_N / 2] != 7.0)
+    fprintf(stderr, "AVISO: sonda de banda inconsistente\n");
+
+  free(a);
+  free(b);
+  free(c);
+
+  return melhor;
+}
+
+/**
+ * Sonda de desempenho de pico: SONDA_ACC cadeias independentes de
+ * acc = acc*x + y, que o compilador vetoriza em instruções FMA.
+ * @return desempenho observado [GFLOP/s]
+ */
+double sondaFlops(void)
+{
+  real_t acc[SONDA_ACC] ALIGN_64;
+  const real_t x = 0.999999, y = 1.0e-7;
+  double soma = 0.0;
+
+  for (int j = 0; j < SONDA_ACC; ++j)
+    acc[j] = j * 1.0e-3;
+
+  rtime_t tempo = timestamp();
+  for (long it = 0; it < SONDA_ITER; ++it)
+  {
+#pragma omp simd aligned(acc : 64)
+    for (int j = 0; j < SONDA_ACC; ++j)
+      acc[j] = acc[j] * x + y;
+  }
+  tempo = timestamp() - tempo;
+
+  // Impede que o compilador elimine o laço
+  for (int j = 0; j < SONDA_ACC; ++j)
+    soma += acc[j];
+  if (soma < 0.0)
+    fprintf(stderr, "AVISO: sonda de FLOPS inconsistente\n");
+
+  return 2.0 * SONDA_ACC * SONDA_ITER / (tempo * 1.0e6);
+}
+
+/**
+ * Tamanho da cache de último nível [bytes], de sysconf() ou, se a libc não
+ * informa, de /sys. 0 se desconhecido.
+ */
+long tamanhoLLC(void)
+{
+  long tam = sysconf(_SC_LEVEL3_CACHE_SIZE);
+  FILE *arq;
+
+  if (tam > 0)
+    return tam;
+
+  if ((arq = fopen("/sys/devices/system/cpu/cpu0/cache/index3/size", "r")))
+  {
+    char unid = 'K';
+    if (fscanf(arq, "%ld%c", &tam, &unid) < 1)
+      tam = 0;
+    else if (unid == 'K')
+      tam *= 1024;
+    else if (unid == 'M')
+      tam *= 1024 * 1024;
+    fclose(arq);
+  }
+
+  return (tam > 0) ? tam : 0;
+}
+
+/* Executa as duas sondas e obtém o tamanho da LLC */
+void mediMaquina(Maquina_t *maq)
+{
+  maq->banda = sondaBanda();
+  maq->pico = sondaFlops();
+  maq->llc = tamanhoLLC();
+}
+
+/* Número de operações de ponto flutuante do kernel 'k' para ordem 'n' */
+double flopsKernel(kernel_t k, int n)
+{
+  return (k == kMatVet || k == kMatVetOtim) ? 2.0 * n * n : 2.0 * n * n * n;
+}
+
+/**
+ * Modelo do tráfego com a memória principal [bytes] do kernel 'k', supondo
+ * que as matrizes não cabem em cache, mas uma linha (ou um bloco) cabe:
+ *  - matVet:       A uma vez; v em cache; res lido e escrito
+ *  - matMat (ijk): B inteira relida para cada linha de C
+ *  - matMat_otim:  cada bloco de A, B e C (leitura e escrita) é carregado
+ *                  ceil(n/BLOCO_OTIM) vezes
+ */
+double bytesKernel(kernel_t k, int n)
+{
+  double nn = (double)n * n;
+  double nb = (n + BLOCO_OTIM - 1) / BLOCO_OTIM;
+
+  switch (k)
+  {
+  case kMatVet:
+  case kMatVetOtim:
+    return sizeof(real_t) * (nn + 3.0 * n);
+  case kMatMat:
+    return sizeof(real_t) * (nn * n + 3.0 * nn);
+  case kMatMatOtim:
+    return sizeof(real_t) * 4.0 * nb * nn;
+  default:
+    return 0.0;
+  }
+}
+
+/* Dados do kernel 'k' [bytes]: matrizes e vetores lidos e escritos */
+double bytesTrabalho(kernel_t k, int n)
+{
+  double nn = (double)n * n;
+
+  return (k == kMatVet || k == kMatVetOtim) ? sizeof(real_t) * (nn + 2.0 * n)
+                                            : sizeof(real_t) * 3.0 * nn;
+}
+
+/* Intensidade aritmética [FLOP/byte] do modelo */
+double intensidadeAritmetica(kernel_t k, int n)
+{
+  return flopsKernel(k, n) / bytesKernel(k, n);
+}
+
+/* Desempenho máximo atingível [GFLOP/s]: min(pico, banda * ia) */
+double tetoRoofline(Maquina_t *maq, double ia)
+{
+  double teto = maq->banda * ia;
+  return (teto < maq->pico) ? teto : maq->pico;
+}
@@ -0,0 +1,38 @@
+#!/usr/bin/gnuplot
+
+# Gráfico roofline dos kernels de 'matriz.c'.
+# Lê os limites da máquina ('benchmark -R Dados/maquina.csv') e as medidas
+# dos kernels ('benchmark -o Dados/benchmark.csv').
+
+MAQ = 'Dados/maquina.csv'
+ARQ = 'Dados/benchmark.csv'
+KERNELS = "matVet matVet_otim matMat matMat_otim"
+
+set datafile separator comma
+
+stats MAQ every ::1 using 1 nooutput
+BANDA = STATS_max
+stats MAQ every ::1 using 2 nooutput
+PICO = STATS_max
+
+set terminal pngcairo size 1200,800
+set output 'Dados/grafico_roofline.png'
+set title sprintf('Roofline (banda %.1f GB/s, pico %.1f GFLOP/s)', BANDA, PICO)
+set xlabel 'Intensidade aritmética [FLOP/byte]'
+set ylabel 'Desempenho [GFLOP/s]'
+set logscale xy
+set xrange [0.01:100]
+set grid
+set key outside right
+
+teto(x) = (BANDA * x < PICO) ? BANDA * x : PICO
+
+# Seleciona coluna 'c' apenas nas linhas do kernel 'k'
+sel(k, c) = (strcol(1) eq k) ? column(c) : NaN
+
+set samples 1000
+plot teto(x) with lines lw 2 lc rgb "black" title 'teto', \
+     for [k in KERNELS] ARQ every ::1 using (sel(k,13)):(sel(k,8)/1000.0) \
+     with linespoints title k
+
+print "Gráfico gerado em Dados/grafico_roofline.png"
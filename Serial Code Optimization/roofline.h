@@ -0,0 +1,37 @@
+#ifndef __ROOFLINE_H__
+#define __ROOFLINE_H__
+
+// Kernels de 'matriz.h' analisados no modelo roofline
+typedef enum {
+  kMatVet = 0,
+  kMatVetOtim,
+  kMatMat,
+  kMatMatOtim,
+  NUM_KERNELS
+} kernel_t;
+
+extern const char *nomeKernel[NUM_KERNELS];
+
+// Limites da máquina (um núcleo), medidos pelas sondas
+typedef struct {
+  double banda;  // banda de memória principal [GB/s] (STREAM triad)
+  double pico;   // desempenho de pico [GFLOP/s] (FMA vetorial)
+  long llc;      // tamanho da cache de último nível [bytes]; 0 se desconhecido
+} Maquina_t;
+
+// Sondas
+double sondaBanda (void);
+double sondaFlops (void);
+void mediMaquina (Maquina_t *maq);
+long tamanhoLLC (void);
+
+// Modelo de cada kernel para ordem 'n'
+double flopsKernel (kernel_t k, int n);
+double bytesKernel (kernel_t k, int n);
+double intensidadeAritmetica (kernel_t k, int n);
+double bytesTrabalho (kernel_t k, int n);
+
+// Desempenho máximo atingível [GFLOP/s] com intensidade 'ia' [FLOP/byte]
+double tetoRoofline (Maquina_t *maq, double ia);
+
+#endif // __ROOFLINE_H__
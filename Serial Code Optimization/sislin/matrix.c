@@ -1,13 +1,22 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <math.h>
 
 #include "matrix.h"
 
+// Ordem dos blocos usados por LU, inversão triangular e GEMM
+#define BLOCO 64
+
+// Produtos com menos operações que isso não são divididos entre threads
+#define GEMM_PAR_MIN (1 << 21)
+
+#define MIN(a,b) ((a) < (b) ? (a) : (b))
+
 /* Cria com calloc() matriz 'n x m' */
 double **criaMatriz (int n, int m)
 {
   double **C;
-  int i, j;
+  int i;
   
   C = (double **) calloc(n,sizeof(double *));
   C[0] = (double *) calloc(n*m,sizeof(double));
@@ -64,28 +73,245 @@ double **invMatriz (double **A, int n)
 
 }
 
+/* C[ci.., cj..] += alfa * A[ai.., aj..] * B[bi.., bj..]
+   A é 'm x k', B é 'k x n', C é 'm x n'. Ordem i-k-j com blocking:
+   linhas de B e C percorridas sequencialmente. C não pode se sobrepor a
+   A ou B. Com OpenMP, blocos de linhas de C são divididos entre threads.
+*/
+static void gemmBloco (double **A, int ai, int aj, double **B, int bi, int bj,
+		       double **C, int ci, int cj, int m, int n, int k, double alfa)
+{
+#pragma omp parallel for schedule(static) if ((double) m * n * k > GEMM_PAR_MIN)
+  for (int ii=0; ii < m; ii += BLOCO)
+    for (int kk=0; kk < k; kk += BLOCO)
+      for (int jj=0; jj < n; jj += BLOCO) {
+	int i_max = MIN(ii+BLOCO, m), k_max = MIN(kk+BLOCO, k), j_max = MIN(jj+BLOCO, n);
+	for (int i=ii; i < i_max; ++i) {
+	  double *c = C[ci+i] + cj;
+	  for (int p=kk; p < k_max; ++p) {
+	    double a = alfa * A[ai+i][aj+p];
+	    double *b = B[bi+p] + bj;
+	    for (int j=jj; j < j_max; ++j)
+	      c[j] += a * b[j];
+	  }
+	}
+      }
+}
+
+/* Troca elementos das colunas [c0,c1) das linhas 'i' e 'p' */
+static void trocaLinhas (double **A, int i, int p, int c0, int c1)
+{
+  for (int j=c0; j < c1; ++j) {
+    double t = A[i][j];
+    A[i][j] = A[p][j];
+    A[p][j] = t;
+  }
+}
+
+/* Fatoração LU com pivoteamento parcial, em blocos, 'in place':
+   P*A = L*U, com L (diagonal unitária) abaixo e U acima da diagonal de A.
+   Cada painel de BLOCO colunas é fatorado e suas trocas de linhas são
+   aplicadas ao restante da matriz de uma só vez; a atualização da
+   submatriz restante é feita por 'gemmBloco()'.
+   'piv[j]' recebe a linha trocada com 'j'.
+   RETORNO: 0, ou -1 se a matriz é singular
+*/
+static int fatoraLU (double **A, int n, int *piv)
+{
+  for (int k0=0; k0 < n; k0 += BLOCO) {
+    int kb = MIN(BLOCO, n-k0), k1 = k0 + kb;
+
+    // Fatoração do painel A[k0:n, k0:k1]
+    for (int j=k0; j < k1; ++j) {
+      int p = j;
+      for (int i=j+1; i < n; ++i)
+	if (fabs(A[i][j]) > fabs(A[p][j]))
+	  p = i;
+      piv[j] = p;
+      if (A[p][j] == 0.0)
+	return -1;
+      if (p != j)
+	trocaLinhas(A, j, p, k0, k1);
+
+      for (int i=j+1; i < n; ++i) {
+	double m = A[i][j] /= A[j][j];
+	for (int c=j+1; c < k1; ++c)
+	  A[i][c] -= m * A[j][c];
+      }
+    }
+
+    // Trocas do painel aplicadas às colunas fora dele
+    for (int j=k0; j < k1; ++j)
+      if (piv[j] != j) {
+	trocaLinhas(A, j, piv[j], 0, k0);
+	trocaLinhas(A, j, piv[j], k1, n);
+      }
+
+    if (k1 < n) {
+      // U12 = inv(L11) * A12
+      for (int j=k0; j < k1; ++j)
+	for (int i=j+1; i < k1; ++i)
+	  for (int c=k1; c < n; ++c)
+	    A[i][c] -= A[i][j] * A[j][c];
+
+      // A22 -= L21 * U12
+      gemmBloco(A, k1, k0, A, k0, k1, A, k1, k1, n-k1, n-k1, kb, -1.0);
+    }
+  }
+
+  return 0;
+}
+
+/* Inverte 'in place' a matriz triangular superior U (parte superior de A).
+   Para cada bloco-coluna j: A[0:j, j] = -inv(U00) * U0j * inv(Ujj), onde
+   o produto por inv(U00) (já invertida) é feito por blocos de linhas com
+   'gemmBloco()'.
+*/
+static void inverteU (double **A, int n)
+{
+  for (int j0=0; j0 < n; j0 += BLOCO) {
+    int jb = MIN(BLOCO, n-j0), j1 = j0 + jb;
+
+    // B = A[0:j0, j0:j1] := inv(U00) * B, blocos de linhas em ordem
+    // crescente: a linha 'I' usa apenas linhas K > I, ainda não alteradas
+    for (int i0=0; i0 < j0; i0 += BLOCO) {
+      int i1 = MIN(i0+BLOCO, j0);
+      for (int i=i0; i < i1; ++i)
+	for (int c=j0; c < j1; ++c) {
+	  double s = A[i][i] * A[i][c];
+	  for (int k=i+1; k < i1; ++k)
+	    s += A[i][k] * A[k][c];
+	  A[i][c] = s;
+	}
+      if (i1 < j0)
+	gemmBloco(A, i0, i1, A, i1, j0, A, i0, j0, i1-i0, jb, j0-i1, 1.0);
+    }
+
+    // B := -B * inv(Ujj)
+    for (int i=0; i < j0; ++i)
+      for (int c=j0; c < j1; ++c) {
+	double s = -A[i][c];
+	for (int k=j0; k < c; ++k)
+	  s -= A[i][k] * A[k][c];
+	A[i][c] = s / A[c][c];
+      }
+
+    // Inverte bloco diagonal Ujj
+    for (int c=j0; c < j1; ++c) {
+      A[c][c] = 1.0 / A[c][c];
+      for (int i=j0; i < c; ++i) {
+	double s = 0.0;
+	for (int k=i; k < c; ++k)
+	  s += A[i][k] * A[k][c];
+	A[i][c] = -s * A[c][c];
+      }
+    }
+  }
+}
+
+/* Inverte 'in place' matriz 'A' 'n x n' alocada com 'criaMatriz()':
+   A = inv(A) = inv(U) * inv(L) * P, a partir da fatoração LU em blocos
+   com pivoteamento parcial. A equação X*L = inv(U) é resolvida por
+   blocos-coluna, da última para a primeira, com 'gemmBloco()'.
+   Usa área auxiliar de n x BLOCO elementos.
+   RETORNO: 0, ou -1 se a matriz é singular ou falha de alocação
+*/
+int invMatrizLU (double **A, int n)
+{
+  int *piv = (int *) malloc(n * sizeof(int));
+  double **W = criaMatriz(n, BLOCO);
+
+  if (!piv || !W || fatoraLU(A, n, piv)) {
+    free(piv);
+    if (W) freeMatriz(W, n);
+    return -1;
+  }
+
+  inverteU(A, n);
+
+  int j0 = ((n-1) / BLOCO) * BLOCO;
+  for (; j0 >= 0; j0 -= BLOCO) {
+    int jb = MIN(BLOCO, n-j0), j1 = j0 + jb;
+
+    // Copia L[:, j0:j1] (abaixo da diagonal) para W e zera em A
+    for (int i=j0; i < n; ++i)
+      for (int c=j0; c < j1; ++c)
+	if (i > c) {
+	  W[i][c-j0] = A[i][c];
+	  A[i][c] = 0.0;
+	}
+	else
+	  W[i][c-j0] = 0.0;
+
+    // A[:, j0:j1] -= A[:, j1:n] * L[j1:n, j0:j1]
+    if (j1 < n)
+      gemmBloco(A, 0, j1, W, j1, 0, A, 0, j0, n, jb, n-j1, -1.0);
+
+    // A[:, j0:j1] := A[:, j0:j1] * inv(Ljj), da direita para a esquerda
+    for (int i=0; i < n; ++i)
+      for (int c=j1-1; c >= j0; --c) {
+	double s = A[i][c];
+	for (int k=c+1; k < j1; ++k)
+	  s -= A[i][k] * W[k][c-j0];
+	A[i][c] = s;
+      }
+  }
+
+  // inv(A) = inv(U)*inv(L)*P: trocas de colunas na ordem inversa
+  for (int j=n-2; j >= 0; --j)
+    if (piv[j] != j)
+      for (int i=0; i < n; ++i) {
+	double t = A[i][j];
+	A[i][j] = A[i][piv[j]];
+	A[i][piv[j]] = t;
+      }
+
+  free(piv);
+  freeMatriz(W, n);
+
+  return 0;
+}
+
+/* Retorna || A*IA - I ||, na norma do máximo, para matrizes 'n x n' */
+double normaResInv (double **A, double **IA, int n)
+{
+  double norma = 0.0;
+  double *r = (double *) malloc(n * sizeof(double));
+
+  for (int i=0; i < n; ++i) {
+    for (int j=0; j < n; ++j)
+      r[j] = (i == j) ? -1.0 : 0.0;
+    for (int k=0; k < n; ++k) {
+      double a = A[i][k];
+      for (int j=0; j < n; ++j)
+	r[j] += a * IA[k][j];
+    }
+    for (int j=0; j < n; ++j)
+      if (fabs(r[j]) > norma)
+	norma = fabs(r[j]);
+  }
+
+  free(r);
+  return norma;
+}
+
 /* Libera matriz com 'n' linhas, alocada com 'criaMatriz()' */
 void freeMatriz (double **A, int n)
 {
-  int i;
-  
   free(A[0]);
   free(A);
 }
 
-/* Multiplica matrizes 'A' e 'B', ambas 'n x n' */
+/* Multiplica matrizes 'A' e 'B', ambas 'n x n'.
+   Resultado é alocado com 'criaMatriz()' (um único bloco contíguo,
+   liberado com 'freeMatriz()') e calculado por 'gemmBloco()'.
+*/
 double **multMatriz (double **A, double **B, int n)
 {
-  double **C;
-  int i, j,k;
-
-  C = (double **) malloc(n*sizeof(double *));
-  for (i=0; i < n; ++i) {
-    C[i] = (double *) calloc(n,sizeof(double));
-    for (j=0; j < n; ++j)
-      for (k=0; k < n; ++k)
-	C[i][j] += A[i][k] * B[k][j];
-  }
+  double **C = criaMatriz(n, n);
+
+  if (C && C[0])
+    gemmBloco(A, 0, 0, B, 0, 0, C, 0, 0, n, n, n, 1.0);
 
   return C;
 }
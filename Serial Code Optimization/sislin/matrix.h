@@ -6,10 +6,21 @@ double **criaMatriz (int n, int m);
 */
 double **invMatriz (double **A, int n);
 
+/* Inverte 'in place' matriz 'A' 'n x n' alocada com 'criaMatriz()', por
+   fatoração LU em blocos com pivoteamento parcial.
+   Retorna 0, ou -1 se 'A' é singular
+*/
+int invMatrizLU (double **A, int n);
+
+/* Retorna || A*IA - I || (norma do máximo), A e IA 'n x n' */
+double normaResInv (double **A, double **IA, int n);
+
 /* Libera matriz com 'n' linhas, alocada com 'criaMatriz()' */
 void freeMatriz (double **A, int n);
 
-/* Multiplica matrizes 'A' e 'B', ambas 'n x n' */
+/* Multiplica matrizes 'A' e 'B', ambas 'n x n'.
+   Resultado é alocado com 'criaMatriz()'
+*/
 double **multMatriz (double **A, double **B, int n);
 
 /* Mostra na tela matriz 'n x n' alocada com 'criaMatriz()' */
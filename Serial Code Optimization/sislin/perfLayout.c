@@ -0,0 +1,147 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <getopt.h> /* getopt */
+
+#include "utils.h"
+#include "sislin.h"
+
+#define DEF_REPETICOES 3
+
+static const char *nomeAloc[NUM_TIPOS_ALOC] = {"pontPont", "pontVet", "pontVetAlin"};
+
+/**
+ * Exibe mensagem de erro indicando forma de uso do programa e termina
+ * o programa.
+ */
+static void usage(char *progname)
+{
+  fprintf(stderr, "Forma de uso: %s [ -r <repeticoes> ] <ordem> [ <ordem> ... ]\n", progname);
+  exit(1);
+}
+
+/* Eliminação de Gauss com pivoteamento parcial seguida de retrossubstituição */
+static void eliminacaoGauss(SistLinear_t *SL, real_t *x)
+{
+  int n = SL->n;
+  real_t **A = SL->A, *b = SL->b;
+
+  for (int i = 0; i < n - 1; ++i)
+  {
+    int p = i;
+    for (int k = i + 1; k < n; ++k)
+      if (fabs(A[k][i]) > fabs(A[p][i]))
+        p = k;
+
+    if (p != i)
+    {
+      for (int j = i; j < n; ++j)
+      {
+        real_t t = A[i][j];
+        A[i][j] = A[p][j];
+        A[p][j] = t;
+      }
+      real_t t = b[i];
+      b[i] = b[p];
+      b[p] = t;
+    }
+
+    for (int k = i + 1; k < n; ++k)
+    {
+      real_t m = A[k][i] / A[i][i];
+      A[k][i] = 0.0;
+      for (int j = i + 1; j < n; ++j)
+        A[k][j] -= A[i][j] * m;
+      b[k] -= b[i] * m;
+    }
+  }
+
+  for (int i = n - 1; i >= 0; --i)
+  {
+    x[i] = b[i];
+    for (int j = i + 1; j < n; ++j)
+      x[i] -= A[i][j] * x[j];
+    x[i] /= A[i][i];
+  }
+}
+
+/**
+ * Programa principal
+ * Forma de uso: perfLayout [ -r <repeticoes> ] <ordem> [ <ordem> ... ]
+ * -r <rep>: execuções de cada medida; reporta o menor tempo (padrão 3)
+ *
+ * Para cada ordem e tipo de alocação de 'tipoAloc_t', mede 'iniSisLin()'
+ * (diagonal dominante) e a eliminação de Gauss sobre o mesmo sistema.
+ * Gera uma linha CSV por medida:
+ *   alocacao,n,ini_ms,gauss_ms,gauss_mflops
+ */
+int main(int argc, char *argv[])
+{
+  int repeticoes = DEF_REPETICOES, opt;
+
+  while ((opt = getopt(argc, argv, "r:")) != -1)
+  {
+    switch (opt)
+    {
+    case 'r':
+      repeticoes = atoi(optarg);
+      if (repeticoes < 1)
+        usage(argv[0]);
+      break;
+    default:
+      usage(argv[0]);
+    }
+  }
+
+  if (optind >= argc)
+    usage(argv[0]);
+
+  printf("alocacao,n,ini_ms,gauss_ms,gauss_mflops\n");
+
+  for (int a = optind; a < argc; ++a)
+  {
+    int n = atoi(argv[a]);
+    real_t *x = (real_t *)malloc(n * sizeof(real_t));
+
+    if (n < 1)
+      usage(argv[0]);
+
+    for (tipoAloc_t t = pontPont; t < NUM_TIPOS_ALOC; ++t)
+    {
+      rtime_t tIni = INFINITY, tGauss = INFINITY, tempo;
+
+      for (int r = 0; r < repeticoes; ++r)
+      {
+        SistLinear_t *SL = alocaSisLin(n, t);
+        if (!SL || !x)
+        {
+          fprintf(stderr, "Falha em alocação de memória !!\n");
+          exit(2);
+        }
+
+        srand(20232);
+        tempo = timestamp();
+        iniSisLin(SL, diagDominante, COEF_MAX);
+        tempo = timestamp() - tempo;
+        if (tempo < tIni)
+          tIni = tempo;
+
+        tempo = timestamp();
+        eliminacaoGauss(SL, x);
+        tempo = timestamp() - tempo;
+        if (tempo < tGauss)
+          tGauss = tempo;
+
+        liberaSisLin(SL);
+      }
+
+      printf("%s,%d,%.10lg,%.10lg,%.10lg\n", nomeAloc[t], n, tIni, tGauss,
+             (2.0 / 3.0) * n * n * (double)n / (tGauss * 1.0e3));
+      fflush(stdout);
+    }
+
+    free(x);
+  }
+
+  return 0;
+}
@@ -0,0 +1,157 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h> /* getopt */
+
+#include "utils.h"
+#include "matrix.h"
+
+/**
+ * Exibe mensagem de erro indicando forma de uso do programa e termina
+ * o programa.
+ */
+static void usage(char *progname)
+{
+  fprintf(stderr, "Forma de uso: %s [ -m ] <ordem> [ <ordem> ... ]\n", progname);
+  exit(1);
+}
+
+/* Preenche 'A' 'n x n' com valores aleatórios em [-1,1] */
+static void geraMatriz(double **A, int n)
+{
+  for (int i = 0; i < n; ++i)
+    for (int j = 0; j < n; ++j)
+      A[i][j] = 2.0 * random() / RAND_MAX - 1.0;
+}
+
+/**
+ * Mede 'multMatriz()' para ordem 'n' e gera a linha CSV
+ *   n,tempo_ms,gflops,erro
+ * onde 'erro' é o maior desvio de C[i][i] para a soma direta
+ * A[i][0..n-1] * B[0..n-1][i].
+ */
+static void perfMult(int n)
+{
+  double **A = criaMatriz(n, n), **B = criaMatriz(n, n), **C;
+  rtime_t tempo;
+  double erro = 0.0;
+
+  if (!A || !B || !A[0] || !B[0])
+  {
+    fprintf(stderr, "Falha em alocação de memória !!\n");
+    exit(2);
+  }
+
+  geraMatriz(A, n);
+  geraMatriz(B, n);
+
+  tempo = timestamp();
+  C = multMatriz(A, B, n);
+  tempo = timestamp() - tempo;
+
+  for (int i = 0; i < n; ++i)
+  {
+    double s = 0.0;
+    for (int k = 0; k < n; ++k)
+      s += A[i][k] * B[k][i];
+    erro = ABS(C[i][i] - s) > erro ? ABS(C[i][i] - s) : erro;
+  }
+
+  printf("%d,%.10lg,%.10lg,%.10lg\n", n, tempo,
+         2.0 * n * n * (double)n / (tempo * 1.0e6), erro);
+  fflush(stdout);
+
+  freeMatriz(A, n);
+  freeMatriz(B, n);
+  freeMatriz(C, n);
+}
+
+/**
+ * Programa principal
+ * Forma de uso: perfMatriz [ -m ] <ordem> [ <ordem> ... ]
+ * -m: mede 'multMatriz()' em vez das inversões (ver 'perfMult()')
+ *
+ * Para cada ordem, inverte a mesma matriz aleatória com 'invMatriz()'
+ * (Gauss-Jordan) e 'invMatrizLU()' (LU em blocos) e gera a linha CSV
+ *   n,tempo_gj_ms,gflops_gj,res_gj,tempo_lu_ms,gflops_lu,res_lu
+ * onde 'res' é || A*inv(A) - I || na norma do máximo. As taxas usam a
+ * contagem de operações de cada método: 4n^3 (Gauss-Jordan sobre a matriz
+ * aumentada) e 2n^3 (LU + inversão triangular + solução de X*L = inv(U)).
+ */
+int main(int argc, char *argv[])
+{
+  int mult = 0, opt;
+
+  while ((opt = getopt(argc, argv, "m")) != -1)
+  {
+    switch (opt)
+    {
+    case 'm':
+      mult = 1;
+      break;
+    default:
+      usage(argv[0]);
+    }
+  }
+
+  if (optind >= argc)
+    usage(argv[0]);
+
+  if (mult)
+    printf("n,tempo_ms,gflops,erro\n");
+  else
+    printf("n,tempo_gj_ms,gflops_gj,res_gj,tempo_lu_ms,gflops_lu,res_lu\n");
+
+  for (int a = optind; a < argc; ++a)
+  {
+    int n = atoi(argv[a]);
+    double **A, **IA, **ILU;
+    rtime_t tGJ, tLU;
+
+    if (n < 1)
+      usage(argv[0]);
+
+    srandom(20232);
+
+    if (mult)
+    {
+      perfMult(n);
+      continue;
+    }
+
+    A = criaMatriz(n, n);
+    ILU = criaMatriz(n, n);
+    if (!A || !ILU || !A[0] || !ILU[0])
+    {
+      fprintf(stderr, "Falha em alocação de memória !!\n");
+      exit(2);
+    }
+
+    geraMatriz(A, n);
+    memcpy(ILU[0], A[0], (size_t)n * n * sizeof(double));
+
+    tGJ = timestamp();
+    IA = invMatriz(A, n);
+    tGJ = timestamp() - tGJ;
+
+    tLU = timestamp();
+    if (invMatrizLU(ILU, n))
+    {
+      fprintf(stderr, "Matriz singular (n = %d)\n", n);
+      exit(3);
+    }
+    tLU = timestamp() - tLU;
+
+    double n3 = (double)n * n * n;
+    printf("%d,%.10lg,%.10lg,%.10lg,%.10lg,%.10lg,%.10lg\n", n,
+           tGJ, 4.0 * n3 / (tGJ * 1.0e6), normaResInv(A, IA, n),
+           tLU, 2.0 * n3 / (tLU * 1.0e6), normaResInv(A, ILU, n));
+    fflush(stdout);
+
+    freeMatriz(A, n);
+    freeMatriz(IA, n);
+    freeMatriz(ILU, n);
+  }
+
+  return 0;
+}
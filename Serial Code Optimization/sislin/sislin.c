@@ -3,8 +3,23 @@
 #include <stdlib.h>
 
 #include "utils.h"
+#include "randomNR.h"
 #include "sislin.h"
 
+/* Tamanho da linha alocada no tipo 'pontVetAlin': 'n' arredondado para
+   múltiplo de 8 elementos (64 bytes), mais 8 se o resultado é potência
+   de 2, para que colunas não caiam no mesmo conjunto da cache.
+*/
+unsigned int ldaSisLin (unsigned int n)
+{
+  unsigned int lda = (n + 7) & ~7u;
+
+  if (isPot2(lda))
+    lda += 8;
+
+  return lda;
+}
+
 // Alocaçao de matriz em memória. 
 SistLinear_t* alocaSisLin (unsigned int n, tipoAloc_t tipo)
 {
@@ -34,6 +49,18 @@ SistLinear_t* alocaSisLin (unsigned int n, tipoAloc_t tipo)
 	SL->A[i] = SL->A[i-1]+n;
       }
     }
+    else if (tipo == pontVetAlin) {
+      unsigned int lda = ldaSisLin(n);
+      if (posix_memalign((void **) &SL->A[0], 64, (size_t) n * lda * sizeof(real_t))) {
+	SL->A[0] = NULL;
+	liberaSisLin(SL);
+	return NULL;
+      }
+
+      for (int i=1; i < n; ++i) {
+	SL->A[i] = SL->A[i-1]+lda;
+      }
+    }
     else if (tipo == pontPont) { // Matriz  como  vetor de  N  ponteiros
 				 // para N vetores de N elementos cada
     
@@ -50,7 +77,7 @@ void liberaSisLin (SistLinear_t *SL)
 {
   if (SL) {
     if (SL->A) {
-      if (SL->tipoAloc_A == pontVet) {
+      if (SL->tipoAloc_A == pontVet || SL->tipoAloc_A == pontVetAlin) {
 	if (SL->A[0]) free (SL->A[0]);
       }
       else if (SL->tipoAloc_A == pontPont) {
@@ -80,12 +107,20 @@ void iniSisLin (SistLinear_t *SL, tipoSistLinear_t tipo, real_t coef_max)
   // para gerar valores no intervalo [0,coef_max]
   real_t invRandMax = ((real_t)coef_max / (real_t)RAND_MAX);
 
+  // Elemento (i,j) de A é o valor 'base + i*n + j' do gerador por contador
+  // e b[i] o valor 'base + n*n + i': o resultado independe da ordem de
+  // cálculo e do número de threads, e 'srand()' continua definindo o SL
+  Ullong base = ((Ullong) rand() << 32) ^ (Ullong) rand();
+  Ullong nn = (Ullong) n * n;
+
   // inicializa vetor b
+#pragma omp simd
   for (unsigned int i=0; i<n; ++i) {
-    SL->b[i] = (real_t)rand() * invRandMax;
+    SL->b[i] = coef_max * nrDhash(base + nn + i);
   }
     
   if (tipo == hilbert) {
+#pragma omp parallel for schedule(static)
     for (unsigned int i=0; i<n; ++i) {
       for (unsigned int j=0; j<n; ++j)  {
 	SL->A[i][j] = 1.0 / (real_t)(i+j+1);
@@ -93,12 +128,22 @@ void iniSisLin (SistLinear_t *SL, tipoSistLinear_t tipo, real_t coef_max)
     }
   }
   else { // inicializa sistema normal e depois altera
-    // inicializa a matriz A
+    // inicializa a matriz A; para 'diagDominante' a soma da linha é
+    // acumulada no mesmo passo e somada ao termo da diagonal
+#pragma omp parallel for schedule(static)
     for (unsigned int i=0; i<n; ++i) {
+      real_t *Ai = SL->A[i];
+      Ullong u = base + (Ullong) i * n;
+      real_t soma = 0.0;
+#pragma omp simd reduction(+:soma)
       for (unsigned int j=0; j<n; ++j)  {
-	SL->A[i][j] = (real_t)rand() * invRandMax;
+	Ai[j] = coef_max * nrDhash(u + j);
+	soma += Ai[j];
       }
+      if (tipo == diagDominante)
+        Ai[i] += soma - Ai[i];
     }
+
     if (tipo == eqNula) {
       // sorteia eq a ser "nula"
       unsigned int nula = rand() % n;
@@ -127,15 +172,6 @@ void iniSisLin (SistLinear_t *SL, tipoSistLinear_t tipo, real_t coef_max)
       }
       SL->b[combDst] = SL->b[combSrc1] + SL->b[combSrc2];
     }
-    else if (tipo == diagDominante) {
-      // aumenta o valor dos termos da diagonal principal
-      for (unsigned int i=0; i<n; ++i) {
-	real_t soma = 0.0;
-	for (unsigned int j=0; j < i; ++j) soma += SL->A[i][j];
-	for (unsigned int j=i+1; j < n; ++j) soma += SL->A[i][j];
-        SL->A[i][i] += soma;
-      }
-    }
   }
 }
 
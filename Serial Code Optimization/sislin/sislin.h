@@ -7,9 +7,16 @@
 // Tipo de alocação para matrizes
 typedef enum {
   pontPont=0, // Matriz como vetor de N ponteiros para vetores de tamanho N
-  pontVet     // Matriz como vetor de N ponteiros para um único vetor de tamanho N*N
+  pontVet,    // Matriz como vetor de N ponteiros para um único vetor de tamanho N*N
+  pontVetAlin // Como 'pontVet', com vetor alinhado em 64 bytes e linhas de
+	      // tamanho 'ldaSisLin(N)' (múltiplo de 8 elementos)
 } tipoAloc_t;
 
+#define NUM_TIPOS_ALOC 3
+
+// Tamanho da linha alocada (leading dimension) no tipo 'pontVetAlin'
+unsigned int ldaSisLin (unsigned int n);
+
 // Estrutura para definiçao de um sistema linear qualquer
 typedef struct {
   real_t **A; // coeficientes
@@ -0,0 +1,102 @@
+/* Vazão dos geradores de números aleatórios
+ *
+ * Compilação: 'make perfRandom' em '../sislin'
+ *
+ * Forma de uso: perfRandom [ <n> ]
+ * Preenche um vetor de 'n' doubles em [0,1) (padrão 10⁸) com cada gerador
+ * e gera uma linha CSV por gerador:
+ *   gerador,n,tempo_ms,mamostras_s,media
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "utils.h"
+#include "randomNR.h"
+
+#define DEF_N 100000000L
+#define SEMENTE 20232
+
+typedef enum {
+  gRandom = 0,  // random() da libc
+  gRand,        // rand() da libc
+  gNrDrandom,   // nrDrandom(), estado global, uma chamada por valor
+  gNrFill,      // nrFill(), NR_FLUXOS fluxos por chamada
+  gNrFillPar,   // nrFillParalelo(), um fluxo por bloco, OpenMP
+  NUM_GERADORES
+} gerador_t;
+
+static const char *nomeGerador[NUM_GERADORES] = {
+  "random", "rand", "nrDrandom", "nrFill", "nrFillParalelo"
+};
+
+static void preenche(gerador_t g, double *buf, size_t n)
+{
+  nrState_t st;
+
+  switch (g)
+  {
+  case gRandom:
+    for (size_t i = 0; i < n; ++i)
+      buf[i] = random() * (1.0 / ((double)RAND_MAX + 1.0));
+    break;
+  case gRand:
+    for (size_t i = 0; i < n; ++i)
+      buf[i] = rand() * (1.0 / ((double)RAND_MAX + 1.0));
+    break;
+  case gNrDrandom:
+    for (size_t i = 0; i < n; ++i)
+      buf[i] = nrDrandom();
+    break;
+  case gNrFill:
+    nrIniEstado(&st, SEMENTE, 0);
+    nrFill(&st, buf, n);
+    break;
+  case gNrFillPar:
+    nrFillParalelo(SEMENTE, buf, n);
+    break;
+  default:
+    break;
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  size_t n = (argc > 1) ? (size_t)atol(argv[1]) : DEF_N;
+  double *buf;
+
+  if (n < 1 || posix_memalign((void **)&buf, 64, n * sizeof(double)))
+  {
+    fprintf(stderr, "Forma de uso: %s [ <n> ]\n", argv[0]);
+    exit(1);
+  }
+
+  srandom(SEMENTE);
+  srand(SEMENTE);
+  nrSeed(SEMENTE);
+
+  // Primeiro toque nas páginas fora da medida
+  for (size_t i = 0; i < n; ++i)
+    buf[i] = 0.0;
+
+  printf("gerador,n,tempo_ms,mamostras_s,media\n");
+
+  for (gerador_t g = 0; g < NUM_GERADORES; ++g)
+  {
+    rtime_t tempo = timestamp();
+    preenche(g, buf, n);
+    tempo = timestamp() - tempo;
+
+    // Média impede que o compilador descarte o preenchimento
+    double soma = 0.0;
+    for (size_t i = 0; i < n; ++i)
+      soma += buf[i];
+
+    printf("%s,%zu,%.10lg,%.10lg,%.17lg\n", nomeGerador[g], n, tempo,
+           n / (tempo * 1.0e3), soma / n);
+  }
+
+  free(buf);
+
+  return 0;
+}
@@ -41,6 +41,138 @@ Doub nrDrandom() { return 5.42101086242752217E-20 * nrRandom64(); }
 // Retorna int-32 bits entre 0 e 2³² - 1
 Uint nrRandom32() { return (Uint) nrRandom64(); }
 
+#ifdef __AVX2__
+#include <immintrin.h>
+
+// Produto de 64 bits (mod 2⁶⁴) de cada elemento de 'a' pela constante
+// 'c' = 'cHi':'cLo' (AVX2 só multiplica 32 x 32 -> 64 bits)
+static inline __m256i mul64(__m256i a, __m256i cLo, __m256i cHi)
+{
+  __m256i lolo = _mm256_mul_epu32(a, cLo);
+  __m256i hilo = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), cLo);
+  __m256i lohi = _mm256_mul_epu32(a, cHi);
+  return _mm256_add_epi64(lolo, _mm256_slli_epi64(_mm256_add_epi64(hilo, lohi), 32));
+}
+
+// Conversão exata de 'x' (sem sinal) para double, com um único
+// arredondamento, como a conversão escalar: 2³²*hi e lo são somados
+// a partir de mantissas de 2⁸⁴ e 2⁵²
+static inline __m256d u64ParaDouble(__m256i x)
+{
+  __m256i lo = _mm256_blend_epi32(x, _mm256_set1_epi64x(0x4330000000000000LL), 0xaa);
+  __m256i hi = _mm256_xor_si256(_mm256_srli_epi64(x, 32), _mm256_set1_epi64x(0x4530000000000000LL));
+  __m256d f = _mm256_sub_pd(_mm256_castsi256_pd(hi), _mm256_set1_pd(0x1.00000001p84)); // 2⁸⁴ + 2⁵²
+  return _mm256_add_pd(f, _mm256_castsi256_pd(lo));
+}
+
+// Gera 'ng' grupos de NR_FLUXOS valores em 'buf'
+static void nrFillGrupos(nrState_t *st, Doub *buf, size_t ng)
+{
+  const __m256i c1Lo = _mm256_set1_epi64x(2862933555777941757ULL & 0xffffffff);
+  const __m256i c1Hi = _mm256_set1_epi64x(2862933555777941757ULL >> 32);
+  const __m256i c2 = _mm256_set1_epi64x(7046029254386353087LL);
+  const __m256i cw = _mm256_set1_epi64x(4294957665U);
+  const __m256d escala = _mm256_set1_pd(5.42101086242752217E-20);
+
+  __m256i u = _mm256_loadu_si256((__m256i *) st->u);
+  __m256i v = _mm256_loadu_si256((__m256i *) st->v);
+  __m256i w = _mm256_loadu_si256((__m256i *) st->w);
+
+  for (size_t g=0; g < ng; ++g) {
+    u = _mm256_add_epi64(mul64(u, c1Lo, c1Hi), c2);
+    v = _mm256_xor_si256(v, _mm256_srli_epi64(v, 17));
+    v = _mm256_xor_si256(v, _mm256_slli_epi64(v, 31));
+    v = _mm256_xor_si256(v, _mm256_srli_epi64(v, 8));
+    w = _mm256_add_epi64(_mm256_mul_epu32(w, cw), _mm256_srli_epi64(w, 32));
+    __m256i x = _mm256_xor_si256(u, _mm256_slli_epi64(u, 21));
+    x = _mm256_xor_si256(x, _mm256_srli_epi64(x, 35));
+    x = _mm256_xor_si256(x, _mm256_slli_epi64(x, 4));
+    x = _mm256_xor_si256(_mm256_add_epi64(x, v), w);
+    _mm256_storeu_pd(buf + g*NR_FLUXOS, _mm256_mul_pd(escala, u64ParaDouble(x)));
+  }
+
+  _mm256_storeu_si256((__m256i *) st->u, u);
+  _mm256_storeu_si256((__m256i *) st->v, v);
+  _mm256_storeu_si256((__m256i *) st->w, w);
+}
+#else
+// Versão escalar, mesma sequência da versão AVX2
+static void nrFillGrupos(nrState_t *st, Doub *buf, size_t ng)
+{
+  for (size_t g=0; g < ng; ++g)
+    for (int l=0; l < NR_FLUXOS; ++l) {
+      Ullong x;
+      st->u[l] = st->u[l] * 2862933555777941757LL + 7046029254386353087LL;
+      st->v[l] ^= st->v[l] >> 17;
+      st->v[l] ^= st->v[l] << 31;
+      st->v[l] ^= st->v[l] >> 8;
+      st->w[l] = 4294957665U*(st->w[l] & 0xffffffff) + (st->w[l] >> 32);
+      x = st->u[l] ^ (st->u[l] << 21);
+      x ^= x >> 35;
+      x ^= x << 4;
+      buf[g*NR_FLUXOS + l] = 5.42101086242752217E-20 * ((x + st->v[l]) ^ st->w[l]);
+    }
+}
+#endif
+
+// Inicia 'st' com a semente 'j' e o número de fluxo 'fluxo'. Cada fluxo
+// recebe a semente j ^ nrHash64(fluxo*NR_FLUXOS + l) e é iniciado como
+// em 'nrSeed()'
+void nrIniEstado(nrState_t *st, Ullong j, Ullong fluxo)
+{
+  Doub descarte[NR_FLUXOS];
+
+  for (int l=0; l < NR_FLUXOS; ++l) {
+    st->v[l] = 4101842887655102017LL;
+    st->w[l] = 1;
+    st->u[l] = (j ^ nrHash64(fluxo*NR_FLUXOS + l)) ^ st->v[l];
+  }
+  nrFillGrupos(st, descarte, 1);
+  for (int l=0; l < NR_FLUXOS; ++l)
+    st->v[l] = st->u[l];
+  nrFillGrupos(st, descarte, 1);
+  for (int l=0; l < NR_FLUXOS; ++l)
+    st->w[l] = st->v[l];
+  nrFillGrupos(st, descarte, 1);
+
+  st->nResto = 0;
+}
+
+// Preenche 'buf' com 'n' doubles entre 0 e 1.0
+void nrFill(nrState_t *st, Doub *buf, size_t n)
+{
+  size_t k = 0;
+
+  // Valores que sobraram da chamada anterior
+  while (k < n && st->nResto > 0)
+    buf[k++] = st->resto[NR_FLUXOS - st->nResto--];
+
+  size_t ng = (n - k) / NR_FLUXOS;
+  nrFillGrupos(st, buf + k, ng);
+  k += ng * NR_FLUXOS;
+
+  if (k < n) {
+    nrFillGrupos(st, st->resto, 1);
+    st->nResto = NR_FLUXOS;
+    while (k < n)
+      buf[k++] = st->resto[NR_FLUXOS - st->nResto--];
+  }
+}
+
+// Preenche 'buf' em paralelo, um fluxo por bloco de NR_BLOCO elementos
+void nrFillParalelo(Ullong j, Doub *buf, size_t n)
+{
+  long nb = (n + NR_BLOCO - 1) / NR_BLOCO;
+
+#pragma omp parallel for schedule(static)
+  for (long b=0; b < nb; ++b) {
+    nrState_t st;
+    size_t ini = (size_t) b * NR_BLOCO;
+    nrIniEstado(&st, j, b);
+    nrFill(&st, buf + ini, (n - ini < NR_BLOCO) ? n - ini : NR_BLOCO);
+  }
+}
+
 /*
 struct Ranq1 {
 	Ullong v;
@@ -51,4 +51,45 @@ Doub nrDrandom();
 // Retorna int-32 bits entre 0 e 2³² - 1
 Uint nrRandom32();
 
+// Estado reentrante do gerador: NR_FLUXOS fluxos independentes, gerados
+// lado a lado (um por elemento de registrador AVX2). Valores gerados e
+// ainda não entregues ficam em 'resto', de forma que a sequência não
+// depende de como os pedidos são divididos entre chamadas.
+#define NR_FLUXOS 4
+
+typedef struct {
+  Ullong u[NR_FLUXOS], v[NR_FLUXOS], w[NR_FLUXOS];
+  Doub resto[NR_FLUXOS];
+  Int nResto;
+} nrState_t;
+
+// Inicia 'st' com a semente 'j' e o número de fluxo 'fluxo'. Estados com
+// mesma semente e fluxos diferentes geram sequências independentes
+void nrIniEstado(nrState_t *st, Ullong j, Ullong fluxo);
+// Preenche 'buf' com 'n' doubles entre 0 e 1.0: o elemento k vem do fluxo
+// k % NR_FLUXOS
+void nrFill(nrState_t *st, Doub *buf, size_t n);
+// Preenche 'buf' em paralelo (OpenMP): bloco b de NR_BLOCO elementos usa o
+// fluxo b da semente 'j'. Resultado independe do número de threads
+#define NR_BLOCO (1 << 16)
+void nrFillParalelo(Ullong j, Doub *buf, size_t n);
+
+// Gerador baseado em contador ("Ranhash", mesma fonte, pp.352): o valor
+// depende apenas de 'u', sem estado. Permite gerar qualquer elemento de uma
+// sequência diretamente (p.ex. u = semente + i*n + j), em qualquer ordem e
+// em paralelo. Inline para que laços sobre 'u' sejam vetorizados.
+
+// Retorna int-64 bits entre 0 e 2⁶⁴ - 1
+static inline Ullong nrHash64(Ullong u)
+{
+  Ullong v = u * 3935559000370003845ULL + 2691343689449507681ULL;
+  v ^= v >> 21; v ^= v << 37; v ^= v >> 4;
+  v *= 4768777513237032717ULL;
+  v ^= v << 20; v ^= v >> 41; v ^= v << 5;
+  return v;
+}
+
+// Retorna double entre 0 e 1.0
+static inline Doub nrDhash(Ullong u) { return 5.42101086242752217E-20 * nrHash64(u); }
+
 #endif /* _RANDOMNR_H_ */
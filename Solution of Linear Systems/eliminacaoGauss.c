@@ -5,6 +5,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <string.h>
 
 #include "utils.h"
 #include "sislin.h"
@@ -30,13 +31,34 @@ static int encontraMax(SistLinear_t *C, int k)
    return linha;
 }
 
-/* Troca de lugar entre si as linhas 'k' e 'p' do SL 'C' */
+/* Troca de lugar entre si as linhas 'k' e 'p' do SL 'C' trocando apenas
+   os ponteiros das linhas: O(1), sem cópia dos coeficientes. A memória
+   continua referenciada por 'C->mem'.
+*/
 static void trocaLinha (SistLinear_t *C, int k, int p)
 {
    if(k == p){
       return;
    }
 
+   real_t *tempLinha = C->A[k];
+   C->A[k] = C->A[p];
+   C->A[p] = tempLinha;
+
+   real_t temp = C->b[k];
+   C->b[k] = C->b[p];
+   C->b[p] = temp;
+}
+
+/* Troca das linhas 'k' e 'p' copiando os 'n' coeficientes um a um.
+   Mantida apenas para comparação com 'trocaLinha()'.
+*/
+static void trocaLinhaCopia (SistLinear_t *C, int k, int p)
+{
+   if(k == p){
+      return;
+   }
+
    real_t temp;
 
    for(int i = 0; i < C->n; i++){
@@ -51,16 +73,24 @@ static void trocaLinha (SistLinear_t *C, int k, int p)
 }
 
 
-/* Seja um S.L. de ordem 'n'
-   C = A|B em Ax=B
+/* Triangularização com a função de troca de linhas 'troca'.
+   RETORNO: número de trocas de linhas efetuadas, ou -1 se não foi
+            possível materializar a cópia de 'C->A'
  */
-void triangulariza( SistLinear_t *C )
+static int triangularizaTroca( SistLinear_t *C,
+                               void (*troca)(SistLinear_t *, int, int) )
 {
+   int trocas = 0;
+
+   if(materializaSisLin(C))
+      return -1;
+
    for(int i = 0; i < C->n - 1; i++) {
 
       int iPivo = encontraMax(C, i);
       if(iPivo != i){
-         trocaLinha(C, i, iPivo);
+         troca(C, i, iPivo);
+         trocas++;
       }
 
       for(int k = i+1; k < C->n; k++) {
@@ -71,12 +101,88 @@ void triangulariza( SistLinear_t *C )
          C->b[k] -= C->b[i] * m;
       }
    }
+
+   return trocas;
+}
+
+/* Seja um S.L. de ordem 'n'
+   C = A|B em Ax=B
+   RETORNO: número de trocas de linhas efetuadas, ou -1 se não foi
+            possível materializar a cópia de 'C->A'
+ */
+int triangulariza( SistLinear_t *C )
+{
+   return triangularizaTroca(C, trocaLinha);
 }
 
-void retrosubst( SistLinear_t *C, real_t *X )
+/* Como 'triangulariza()', trocando linhas por cópia dos coeficientes.
+   RETORNO: número de trocas de linhas efetuadas, ou -1 (ver 'triangulariza()')
+ */
+int triangularizaCopia( SistLinear_t *C )
+{
+   return triangularizaTroca(C, trocaLinhaCopia);
+}
+
+/* Triangularização com as linhas abaixo do pivô atualizadas em paralelo
+   (OpenMP) e busca do pivô como redução paralela do máximo. Empates ficam
+   com o menor índice, como em 'encontraMax()': o resultado é idêntico ao
+   de 'triangulariza()'.
+   RETORNO: 0 se sucesso, -1 se não foi possível materializar 'C->A'
+ */
+int triangularizaPar( SistLinear_t *C )
 {
-   triangulariza(C);
+   int n = C->n;
+   int iPivo;
+   real_t max;
+
+   if(materializaSisLin(C))
+      return -1;
+
+#pragma omp parallel
+   for(int i = 0; i < n - 1; i++) {
+      int linha = i;
+      real_t maxLocal = -1.0;
+
+#pragma omp single
+      {
+         iPivo = i;
+         max = -1.0;
+      }
+
+#pragma omp for schedule(static) nowait
+      for(int k = i; k < n; k++)
+         if(fabs(C->A[k][i]) > maxLocal) {
+            maxLocal = fabs(C->A[k][i]);
+            linha = k;
+         }
+
+#pragma omp critical
+      if(maxLocal > max || (maxLocal == max && linha < iPivo)) {
+         max = maxLocal;
+         iPivo = linha;
+      }
+#pragma omp barrier
+
+#pragma omp single
+      if(iPivo != i)
+         trocaLinha(C, i, iPivo);
+
+#pragma omp for schedule(static)
+      for(int k = i+1; k < n; k++) {
+         real_t m = C->A[k][i] / C->A[i][i];
+         for(int j = i+1; j < n; j++) {
+            C->A[k][j] -= C->A[i][j] * m;
+         }
+         C->b[k] -= C->b[i] * m;
+      }
+   }
+
+   return 0;
+}
 
+/* Retrossubstituição sobre o SL triangular superior 'C' */
+static void retroTriangular( SistLinear_t *C, real_t *X )
+{
    for(int i = (C->n - 1); i >= 0; i--) {
       X[i] = C->b[i];
       for(int j = i+1; j < C->n; j++) {
@@ -84,4 +190,450 @@ void retrosubst( SistLinear_t *C, real_t *X )
       }
       X[i] /= C->A[i][i];
    }
-}
\ No newline at end of file
+}
+
+/* Como 'retrosubst()', com 'triangularizaPar()' */
+int retrosubstPar( SistLinear_t *C, real_t *X )
+{
+   if(triangularizaPar(C) < 0)
+      return -1;
+
+   retroTriangular(C, X);
+   return 0;
+}
+
+/* Eliminação de Gauss com pivoteamento parcial e retrossubstituição.
+   RETORNO: 0 se sucesso, -1 se a triangularização falhou ('X' intacto)
+ */
+int retrosubst( SistLinear_t *C, real_t *X )
+{
+   if(triangulariza(C) < 0)
+      return -1;
+
+   retroTriangular(C, X);
+   return 0;
+}
+
+
+/* M[ci.., cj..] -= M[ai.., aj..] * M[bi.., bj..], blocos 'm x k' e 'k x n'
+   da mesma matriz, que não podem se sobrepor ao bloco de saída.
+   Ordem i-k-j em blocos de BLOCO_LU: linhas percorridas sequencialmente.
+*/
+static void gemmSub(real_t **M, int ci, int cj, int ai, int aj, int bi, int bj,
+                    int m, int n, int k)
+{
+   for(int ii = 0; ii < m; ii += BLOCO_LU)
+      for(int kk = 0; kk < k; kk += BLOCO_LU)
+         for(int jj = 0; jj < n; jj += BLOCO_LU) {
+            int iMax = MIN(ii + BLOCO_LU, m);
+            int kMax = MIN(kk + BLOCO_LU, k);
+            int jMax = MIN(jj + BLOCO_LU, n);
+            for(int i = ii; i < iMax; i++) {
+               real_t *c = M[ci + i] + cj;
+               for(int p = kk; p < kMax; p++) {
+                  real_t a = M[ai + i][aj + p];
+                  real_t *b = M[bi + p] + bj;
+                  for(int j = jj; j < jMax; j++)
+                     c[j] -= a * b[j];
+               }
+            }
+         }
+}
+
+/* Troca elementos das colunas [c0,c1) das linhas 'k' e 'p' */
+static void trocaSubLinha(real_t **A, int k, int p, int c0, int c1)
+{
+   for(int j = c0; j < c1; j++) {
+      real_t temp = A[k][j];
+      A[k][j] = A[p][j];
+      A[p][j] = temp;
+   }
+}
+
+/* Fatora o painel A[k0:n, k0:k1], trocando linhas apenas nas colunas do
+   painel e registrando as trocas em 'piv[k0:k1]'.
+   RETORNO: 0, ou -1 se a matriz é singular
+*/
+static int fatoraPainel(real_t **A, int n, int k0, int k1, int *piv)
+{
+   for(int k = k0; k < k1; k++) {
+      int iPivo = k;
+      for(int i = k+1; i < n; i++)
+         if(fabs(A[i][k]) > fabs(A[iPivo][k]))
+            iPivo = i;
+
+      piv[k] = iPivo;
+      if(A[iPivo][k] == 0.0)
+         return -1;
+      if(iPivo != k)
+         trocaSubLinha(A, k, iPivo, k0, k1);
+
+      for(int i = k+1; i < n; i++) {
+         real_t m = A[i][k] /= A[k][k];
+         for(int j = k+1; j < k1; j++)
+            A[i][j] -= A[k][j] * m;
+      }
+   }
+
+   return 0;
+}
+
+/* Aplica o painel [k0,k1) às colunas [j0,j1), à direita do painel:
+   trocas de linhas do painel, U = inv(L11) * A[k0:k1, j0:j1] e
+   atualização A[k1:n, j0:j1] -= L21 * U com 'gemmSub()'.
+*/
+static void atualizaBloco(real_t **A, int n, int k0, int k1, int j0, int j1, int *piv)
+{
+   for(int k = k0; k < k1; k++)
+      if(piv[k] != k)
+         trocaSubLinha(A, k, piv[k], j0, j1);
+
+   for(int k = k0; k < k1; k++)
+      for(int i = k+1; i < k1; i++)
+         for(int j = j0; j < j1; j++)
+            A[i][j] -= A[i][k] * A[k][j];
+
+   if(k1 < n)
+      gemmSub(A, k1, j0, k1, k0, k0, j0, n - k1, j1 - j0, k1 - k0);
+}
+
+/* Trocas do painel [k0,k1) aplicadas às colunas à esquerda dele, [0,k0) */
+static void trocasEsquerda(real_t **A, int k0, int k1, int *piv)
+{
+   for(int k = k0; k < k1; k++)
+      if(piv[k] != k)
+         trocaSubLinha(A, k, piv[k], 0, k0);
+}
+
+/* Fatoração LU 'right-looking' em blocos, com pivoteamento parcial, de 'A'
+   'n x n' no lugar: P*A = L*U, L com diagonal unitária abaixo da diagonal.
+   Para cada painel de BLOCO_LU colunas:
+     1. fatoração do painel, trocando linhas apenas dentro dele;
+     2. trocas do painel aplicadas de uma vez às demais colunas;
+     3. U12 = inv(L11) * A12;
+     4. atualização A22 -= L21 * U12 com 'gemmSub()'.
+   'piv[k]' recebe a linha trocada com a linha 'k'.
+   RETORNO: 0, ou LU_SINGULAR se a matriz é singular
+*/
+int fatoraLUBlocado(real_t **A, int n, int *piv)
+{
+   for(int k0 = 0; k0 < n; k0 += BLOCO_LU) {
+      int k1 = MIN(k0 + BLOCO_LU, n);
+
+      if(fatoraPainel(A, n, k0, k1, piv))
+         return LU_SINGULAR;
+
+      trocasEsquerda(A, k0, k1, piv);
+      if(k1 < n)
+         atualizaBloco(A, n, k0, k1, k1, n, piv);
+   }
+
+   return 0;
+}
+
+/* Mesma fatoração de 'fatoraLUBlocado()' como grafo de tarefas OpenMP
+   sobre blocos-coluna de BLOCO_LU colunas: a tarefa do painel 'k' depende
+   apenas da atualização do bloco 'k' pelo painel anterior, e pode
+   executar enquanto o restante da submatriz ainda é atualizado
+   ('lookahead'). A tarefa de atualização do bloco 'j' pelo painel 'k'
+   depende do painel 'k' e da atualização anterior do bloco 'j'.
+   O resultado é idêntico ao de 'fatoraLUBlocado()'.
+   RETORNO: 0, LU_SINGULAR ou LU_SEM_MEMORIA
+*/
+int fatoraLUTarefas(real_t **A, int n, int *piv)
+{
+   int nb = (n + BLOCO_LU - 1) / BLOCO_LU;
+   char *dep = (char *) malloc(nb);  // sentinelas das dependências
+   int singular = 0;
+
+   if(!dep)
+      return LU_SEM_MEMORIA;
+
+#pragma omp parallel
+#pragma omp single
+   for(int kb = 0; kb < nb; kb++) {
+      int k0 = kb * BLOCO_LU, k1 = MIN(k0 + BLOCO_LU, n);
+
+#pragma omp task depend(inout: dep[kb]) shared(singular)
+      {
+         int s;
+#pragma omp atomic read
+         s = singular;
+         if(!s && fatoraPainel(A, n, k0, k1, piv)) {
+#pragma omp atomic write
+            singular = 1;
+         }
+      }
+
+      for(int jb = kb+1; jb < nb; jb++) {
+         int j0 = jb * BLOCO_LU, j1 = MIN(j0 + BLOCO_LU, n);
+#pragma omp task depend(in: dep[kb]) depend(inout: dep[jb]) shared(singular)
+         {
+            int s;
+#pragma omp atomic read
+            s = singular;
+            if(!s)
+               atualizaBloco(A, n, k0, k1, j0, j1, piv);
+         }
+      }
+   }
+
+   free(dep);
+   if(singular)
+      return LU_SINGULAR;
+
+   // Colunas de L já fatoradas não mudam mais: trocas de cada painel
+   // aplicadas à esquerda dele ao final, na ordem da fatoração
+   for(int k0 = BLOCO_LU; k0 < n; k0 += BLOCO_LU)
+      trocasEsquerda(A, k0, MIN(k0 + BLOCO_LU, n), piv);
+
+   return 0;
+}
+
+/* Resolve L*U*X = P*b com os fatores de 'fatoraLUBlocado()' */
+void substLU(real_t **A, int n, int *piv, real_t *b, real_t *X)
+{
+   for(int i = 0; i < n; i++)
+      X[i] = b[i];
+
+   for(int k = 0; k < n; k++)
+      if(piv[k] != k) {
+         real_t temp = X[k];
+         X[k] = X[piv[k]];
+         X[piv[k]] = temp;
+      }
+
+   for(int i = 1; i < n; i++)
+      for(int j = 0; j < i; j++)
+         X[i] -= A[i][j] * X[j];
+
+   for(int i = n-1; i >= 0; i--) {
+      for(int j = i+1; j < n; j++)
+         X[i] -= A[i][j] * X[j];
+      X[i] /= A[i][i];
+   }
+}
+
+/* Como 'retrosubstBlocado()', com o grafo de tarefas de 'fatoraLUTarefas()' */
+int retrosubstTarefas( SistLinear_t *C, real_t *X )
+{
+   int *piv = (int *) malloc(C->n * sizeof(int));
+   int ret = LU_SEM_MEMORIA;
+
+   if(piv && !materializaSisLin(C) && !(ret = fatoraLUTarefas(C->A, C->n, piv)))
+      substLU(C->A, C->n, piv, C->b, X);
+
+   free(piv);
+   return ret;
+}
+
+/* Resíduo dos fatores P*A = L*U de 'fatoraLUBlocado()', para quando A
+   não está mais disponível: R = P^T * (P*b - L*(U*X)), em O(n²).
+   Não é o resíduo b - A*X: com os mesmos fatores que produziram X, mede
+   apenas o arredondamento das substituições, e fica perto de 0 mesmo se
+   a fatoração é ruim.
+   RETORNO: 0, ou -1 em caso de falha de alocação ('R' indefinido)
+*/
+int residuoLU(real_t **LU, int n, int *piv, real_t *b, real_t *X, real_t *R)
+{
+   real_t *y = (real_t *) malloc(n * sizeof(real_t));
+
+   if(!y)
+      return -1;
+
+   for(int i = 0; i < n; i++) {
+      y[i] = 0.0;
+      for(int j = i; j < n; j++)
+         y[i] += LU[i][j] * X[j];
+   }
+
+   for(int i = 0; i < n; i++)
+      R[i] = b[i];
+   for(int k = 0; k < n; k++)
+      if(piv[k] != k) {
+         real_t temp = R[k];
+         R[k] = R[piv[k]];
+         R[piv[k]] = temp;
+      }
+
+   for(int i = n-1; i >= 0; i--) {
+      real_t z = y[i];
+      for(int j = 0; j < i; j++)
+         z += LU[i][j] * y[j];
+      R[i] -= z;
+   }
+
+   for(int k = n-1; k >= 0; k--)
+      if(piv[k] != k) {
+         real_t temp = R[k];
+         R[k] = R[piv[k]];
+         R[piv[k]] = temp;
+      }
+
+   free(y);
+   return 0;
+}
+
+/* Como 'retrosubst()', com a fatoração LU em blocos: destrói 'C->A'.
+   RETORNO: 0, LU_SINGULAR ou LU_SEM_MEMORIA
+*/
+int retrosubstBlocado( SistLinear_t *C, real_t *X )
+{
+   int *piv = (int *) malloc(C->n * sizeof(int));
+   int ret = LU_SEM_MEMORIA;
+
+   if(piv && !materializaSisLin(C) && !(ret = fatoraLUBlocado(C->A, C->n, piv)))
+      substLU(C->A, C->n, piv, C->b, X);
+
+   free(piv);
+   return ret;
+}
+
+/* Fatora a matriz de 'SL' sem alterá-la: copia 'SL->A' e aplica
+   'fatoraLUBlocado()' à cópia.
+   RETORNO: fatoração, ou NULL se a matriz é singular ou falha de alocação
+*/
+FatLU_t *fatoraLU(SistLinear_t *SL)
+{
+   int n = SL->n;
+   FatLU_t *F = (FatLU_t *) calloc(1, sizeof(FatLU_t));
+
+   if(!F)
+      return NULL;
+
+   F->n = n;
+   F->piv = (int *) malloc(n * sizeof(int));
+   F->LU = (real_t **) malloc(n * sizeof(real_t *));
+   if(F->LU)
+      F->LU[0] = (real_t *) malloc((size_t) n * n * sizeof(real_t));
+
+   if(!F->piv || !F->LU || !F->LU[0]) {
+      liberaFatLU(F);
+      return NULL;
+   }
+
+   for(int i = 1; i < n; i++)
+      F->LU[i] = F->LU[i-1] + n;
+   for(int i = 0; i < n; i++)
+      for(int j = 0; j < n; j++)
+         F->LU[i][j] = SL->A[i][j];
+
+   if(fatoraLUBlocado(F->LU, n, F->piv)) {
+      liberaFatLU(F);
+      return NULL;
+   }
+
+   return F;
+}
+
+void liberaFatLU(FatLU_t *F)
+{
+   if(F) {
+      if(F->LU) {
+         free(F->LU[0]);
+         free(F->LU);
+      }
+      free(F->piv);
+      free(F);
+   }
+}
+
+/* Resolve A*X = b com a fatoração 'F', em O(n²) */
+void resolveLU(FatLU_t *F, real_t *b, real_t *X)
+{
+   substLU(F->LU, F->n, F->piv, b, X);
+}
+
+/* Resolve A*X = B para 'm' lados direitos de uma vez. 'B' é 'n x m' (coluna
+   'r' é o lado direito 'r') e recebe as soluções. Cada passo das
+   substituições atualiza a linha inteira de 'B', em acesso contíguo.
+*/
+void resolveLUMult(FatLU_t *F, real_t **B, int m)
+{
+   int n = F->n;
+   real_t **LU = F->LU;
+
+   for(int k = 0; k < n; k++)
+      if(F->piv[k] != k) {
+         real_t *bk = B[k], *bp = B[F->piv[k]];
+         for(int r = 0; r < m; r++) {
+            real_t temp = bk[r];
+            bk[r] = bp[r];
+            bp[r] = temp;
+         }
+      }
+
+   for(int i = 1; i < n; i++)
+      for(int j = 0; j < i; j++) {
+         real_t l = LU[i][j];
+         for(int r = 0; r < m; r++)
+            B[i][r] -= l * B[j][r];
+      }
+
+   for(int i = n-1; i >= 0; i--) {
+      for(int j = i+1; j < n; j++) {
+         real_t u = LU[i][j];
+         for(int r = 0; r < m; r++)
+            B[i][r] -= u * B[j][r];
+      }
+      real_t d = 1.0 / LU[i][i];
+      for(int r = 0; r < m; r++)
+         B[i][r] *= d;
+   }
+}
+
+/* Refinamento iterativo de X, solução aproximada de SL: r = b - AX com
+   'residuoNormas()' (produto escalar compensado, equivalente a precisão
+   estendida), correção d de A*d = r com os fatores de 'F', em O(n²), e
+   X += d. Para quando a norma L2 do resíduo não cai pelo menos pelo fator
+   REFINA_FATOR (estagnação), se anula ou após 'maxit' iterações. Uma
+   correção que aumenta o resíduo é descartada.
+   @param normaIni recebe a norma L2 do resíduo de X na entrada
+   @param normaFim recebe a norma L2 do resíduo de X na saída
+   RETORNO: número de correções aplicadas, ou -1 se falha de alocação
+*/
+int refinaLU(FatLU_t *F, SistLinear_t *SL, real_t *X, int maxit, real_t *normaIni, real_t *normaFim)
+{
+   int n = F->n, it;
+   real_t *R = (real_t *) malloc(n * sizeof(real_t));
+   real_t *D = (real_t *) malloc(n * sizeof(real_t));
+   real_t *Xant = (real_t *) malloc(n * sizeof(real_t));
+
+   if(!R || !D || !Xant) {
+      free(R);
+      free(D);
+      free(Xant);
+      return -1;
+   }
+
+   real_t norma = residuoNormas(SL, X, R, n, NULL);
+   *normaIni = norma;
+
+   for(it = 0; it < maxit && norma > 0.0; it++) {
+      resolveLU(F, R, D);
+
+      memcpy(Xant, X, n * sizeof(real_t));
+      for(int i = 0; i < n; i++)
+         X[i] += D[i];
+
+      real_t nova = residuoNormas(SL, X, R, n, NULL);
+      if(nova > norma) {
+         memcpy(X, Xant, n * sizeof(real_t));
+         break;
+      }
+
+      int estagnou = (nova > REFINA_FATOR * norma);
+      norma = nova;
+      if(estagnou) {
+         it++;
+         break;
+      }
+   }
+
+   *normaFim = norma;
+
+   free(R);
+   free(D);
+   free(Xant);
+   return it;
+}
@@ -1,2 +1,45 @@
-void triangulariza( SistLinear_t *C );
-void retrosubst( SistLinear_t *C, real_t *X );
+int triangulariza( SistLinear_t *C );
+int triangularizaCopia( SistLinear_t *C );
+int retrosubst( SistLinear_t *C, real_t *X );
+
+// Versão paralela (OpenMP) de 'triangulariza()'/'retrosubst()'
+int triangularizaPar( SistLinear_t *C );
+int retrosubstPar( SistLinear_t *C, real_t *X );
+
+// Ordem dos blocos da fatoração LU em blocos
+#define BLOCO_LU 64
+
+#define MIN(a,b) ((a) < (b) ? (a) : (b))
+
+// Retornos de erro da LU em blocos
+#define LU_SINGULAR (-1)
+#define LU_SEM_MEMORIA (-2)
+
+int fatoraLUBlocado(real_t **A, int n, int *piv);
+void substLU(real_t **A, int n, int *piv, real_t *b, real_t *X);
+int residuoLU(real_t **LU, int n, int *piv, real_t *b, real_t *X, real_t *R);
+int retrosubstBlocado( SistLinear_t *C, real_t *X );
+
+// LU em blocos como grafo de tarefas OpenMP
+int fatoraLUTarefas(real_t **A, int n, int *piv);
+int retrosubstTarefas( SistLinear_t *C, real_t *X );
+
+// Fatoração LU reutilizável: P*A = L*U, fatorada uma vez e usada para
+// resolver qualquer número de lados direitos em O(n²) cada
+typedef struct {
+  int n;
+  real_t **LU; // L (diagonal unitária, abaixo da diagonal) e U
+  int *piv;    // piv[k]: linha trocada com 'k' na fatoração
+} FatLU_t;
+
+FatLU_t *fatoraLU(SistLinear_t *SL);
+void liberaFatLU(FatLU_t *F);
+void resolveLU(FatLU_t *F, real_t *b, real_t *X);
+void resolveLUMult(FatLU_t *F, real_t **B, int m);
+
+// Refinamento iterativo com os fatores de 'F': máximo de iterações e
+// redução mínima do resíduo por iteração para continuar
+#define REFINA_MAXIT 10
+#define REFINA_FATOR 0.5
+
+int refinaLU(FatLU_t *F, SistLinear_t *SL, real_t *X, int maxit, real_t *normaIni, real_t *normaFim);
@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 
 #include "utils.h"
@@ -31,16 +32,21 @@ int gaussSeidel(SistLinear_t *C, real_t *X, real_t erro, int maxit, real_t *norm
             // Guarda o valor de X[i] da iteração anterior para calcular o erro
             real_t x_old = X[i];
 
-            soma = C->b[i]; // Inicia a soma com o termo independente b_i
-            
-            // Calcula o somatório da fórmula de Gauss-Seidel
-            for (j = 0; j < C->n; j++) {
-                if (i != j) {
-                    // Utiliza os valores de X já atualizados nesta mesma iteração (k)
-                    // para j < i, que é a característica principal do método.
-                    soma -= C->A[i][j] * X[j];
-                }
-            }
+            real_t *Ai = C->A[i];
+            real_t somaInf = 0.0, somaSup = 0.0;
+
+            // Calcula o somatório da fórmula de Gauss-Seidel, dividido na
+            // diagonal para evitar o teste 'j != i' e vetorizar as duas partes.
+            // Para j < i são usados os valores de X já atualizados nesta
+            // mesma iteração (k), que é a característica principal do método.
+#pragma omp simd reduction(+:somaInf)
+            for (j = 0; j < i; j++)
+                somaInf += Ai[j] * X[j];
+#pragma omp simd reduction(+:somaSup)
+            for (j = i+1; j < C->n; j++)
+                somaSup += Ai[j] * X[j];
+
+            soma = C->b[i] - somaInf - somaSup; // b_i menos o somatório
 
             // Calcula o novo valor de X[i]
             X[i] = soma / C->A[i][i];
@@ -64,3 +70,154 @@ int gaussSeidel(SistLinear_t *C, real_t *X, real_t erro, int maxit, real_t *norm
     return -1; 
 }
 
+/**
+ * Gauss-Seidel em blocos paralelo: as linhas são divididas em blocos de
+ * BLOCO_GS linhas, atualizados em paralelo (OpenMP). Dentro de um bloco
+ * vale Gauss-Seidel (valores novos do próprio bloco); entre blocos vale
+ * Jacobi (valores da iteração anterior, em uma cópia 'Xold'). Como os
+ * blocos têm tamanho fixo, o resultado não depende do número de threads.
+ *
+ * @param C Ponteiro para a estrutura do sistema linear.
+ * @param X Vetor de incógnitas (deve ser inicializado com zeros pelo chamador).
+ * @param erro Critério de parada (tolerância do erro).
+ * @param maxit Número máximo de iterações.
+ * @param norma Ponteiro para armazenar a norma do erro da última iteração
+ *              (NAN se nenhuma iteração foi executada).
+ * @return O número de iterações executadas em caso de convergência, -1 caso
+ *         contrário, ou GS_SEM_MEMORIA se falha de alocação.
+ */
+int gaussSeidelBlocos(SistLinear_t *C, real_t *X, real_t erro, int maxit, real_t *norma)
+{
+    int n = C->n;
+    int nb = (n + BLOCO_GS - 1) / BLOCO_GS;
+    real_t *Xold = (real_t *) malloc(n * sizeof(real_t));
+
+    *norma = NAN;
+    if (!Xold)
+        return GS_SEM_MEMORIA;
+
+    for (int k = 0; k < maxit; k++) {
+        real_t maxDiff = 0.0;
+
+        memcpy(Xold, X, n * sizeof(real_t));
+
+#pragma omp parallel for schedule(static) reduction(max:maxDiff)
+        for (int bl = 0; bl < nb; bl++) {
+            int i0 = bl * BLOCO_GS;
+            int i1 = (i0 + BLOCO_GS < n) ? i0 + BLOCO_GS : n;
+
+            for (int i = i0; i < i1; i++) {
+                real_t *Ai = C->A[i];
+                real_t s1 = 0.0, s2 = 0.0, s3 = 0.0;
+
+                // Outros blocos à esquerda: iteração anterior
+#pragma omp simd reduction(+:s1)
+                for (int j = 0; j < i0; j++)
+                    s1 += Ai[j] * Xold[j];
+                // Próprio bloco, antes da diagonal: valores novos
+#pragma omp simd reduction(+:s2)
+                for (int j = i0; j < i; j++)
+                    s2 += Ai[j] * X[j];
+                // Depois da diagonal: ainda não atualizados (Xold == X no bloco)
+#pragma omp simd reduction(+:s3)
+                for (int j = i+1; j < n; j++)
+                    s3 += Ai[j] * Xold[j];
+
+                X[i] = (C->b[i] - s1 - s2 - s3) / Ai[i];
+
+                real_t diff = fabs(X[i] - Xold[i]);
+                if (diff > maxDiff)
+                    maxDiff = diff;
+            }
+        }
+
+        *norma = maxDiff;
+        if (*norma < erro) {
+            free(Xold);
+            return k + 1;
+        }
+    }
+
+    free(Xold);
+    return -1;
+}
+
+/**
+ * Executa o método SOR (sobre-relaxação sucessiva): cada X[i] de
+ * Gauss-Seidel é combinado ao valor anterior, X[i] = (1-w)*X[i] + w*X_gs.
+ *
+ * Com '*omega' <= 0, 'w' é estimado durante a execução: as primeiras
+ * iterações são de Gauss-Seidel (w = 1), e a razão entre normas
+ * consecutivas estima o fator de contração 'rho' de Gauss-Seidel. Quando a
+ * razão se estabiliza (variação menor que 10% de 1 - rho), ou após maxit/4
+ * iterações, w = 2 / (1 + sqrt(1 - rho)), limitado a [1, OMEGA_MAX] (valor
+ * ótimo para matrizes com ordenação consistente). Se depois disso a norma
+ * passar de FATOR_DIV_SOR vezes a norma da troca, volta para w = 1.
+ *
+ * @param C Ponteiro para a estrutura do sistema linear.
+ * @param X Vetor de incógnitas (deve ser inicializado com zeros pelo chamador).
+ * @param erro Critério de parada (tolerância do erro).
+ * @param maxit Número máximo de iterações.
+ * @param norma Ponteiro para armazenar a norma do erro da última iteração.
+ * @param omega Fator de relaxação; <= 0 para estimativa automática.
+ *              Recebe o fator usado na última iteração.
+ * @return O número de iterações executadas em caso de convergência, ou -1 caso contrário.
+ */
+int sor(SistLinear_t *C, real_t *X, real_t erro, int maxit, real_t *norma, real_t *omega)
+{
+    int n = C->n;
+    int estimando = (*omega <= 0.0);
+    real_t w = estimando ? 1.0 : *omega;
+    real_t normaAnt = 0.0, rho = 1.0, normaTroca = 0.0;
+
+    for (int k = 0; k < maxit; k++) {
+        *norma = 0.0;
+
+        for (int i = 0; i < n; i++) {
+            real_t *Ai = C->A[i];
+            real_t somaInf = 0.0, somaSup = 0.0;
+
+#pragma omp simd reduction(+:somaInf)
+            for (int j = 0; j < i; j++)
+                somaInf += Ai[j] * X[j];
+#pragma omp simd reduction(+:somaSup)
+            for (int j = i+1; j < n; j++)
+                somaSup += Ai[j] * X[j];
+
+            real_t x_gs = (C->b[i] - somaInf - somaSup) / Ai[i];
+            real_t x_new = X[i] + w * (x_gs - X[i]);
+            real_t diff = fabs(x_new - X[i]);
+
+            X[i] = x_new;
+            if (diff > *norma)
+                *norma = diff;
+        }
+
+        *omega = w;
+        if (*norma < erro)
+            return k + 1;
+
+        if (estimando && k > 0) {
+            // Contração de Gauss-Seidel: razão entre normas consecutivas
+            real_t rhoAnt = rho;
+            rho = *norma / normaAnt;
+            if (k >= maxit / 4 || fabs(rho - rhoAnt) < 0.1 * (1.0 - rho)) {
+                estimando = 0;
+                if (rho < 1.0) {
+                    w = 2.0 / (1.0 + sqrt(1.0 - rho));
+                    if (w > OMEGA_MAX)
+                        w = OMEGA_MAX;
+                    normaTroca = *norma;
+                }
+            }
+        }
+        else if (normaTroca > 0.0 && *norma > FATOR_DIV_SOR * normaTroca) {
+            // Divergência com o 'w' estimado: volta para Gauss-Seidel
+            w = 1.0;
+            normaTroca = 0.0;
+        }
+        normaAnt = *norma;
+    }
+
+    return -1;
+}
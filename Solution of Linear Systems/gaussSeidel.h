@@ -1 +1,16 @@
 int gaussSeidel (SistLinear_t *C, real_t *X, real_t erro, int maxit, real_t *norma);
+
+// Linhas por bloco em 'gaussSeidelBlocos()'
+#define BLOCO_GS 256
+
+// Retorno de 'gaussSeidelBlocos()' em caso de falha de alocação
+#define GS_SEM_MEMORIA (-2)
+
+int gaussSeidelBlocos (SistLinear_t *C, real_t *X, real_t erro, int maxit, real_t *norma);
+
+// SOR: maior 'omega' admitido na estimativa automática e crescimento da
+// norma considerado divergência após a estimativa
+#define OMEGA_MAX 1.95
+#define FATOR_DIV_SOR 100.0
+
+int sor (SistLinear_t *C, real_t *X, real_t erro, int maxit, real_t *norma, real_t *omega);
@@ -1,26 +1,617 @@
 #include <stdio.h>
 #include <fenv.h>
+#include <math.h>
 #include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <unistd.h>
+#include <sys/stat.h>
 #include <likwid.h>
 #include "utils.h"
 #include "sislin.h"
 #include "eliminacaoGauss.h"
 #include "gaussSeidel.h"
 
-int main() {
+/**
+ * Exibe mensagem de erro indicando forma de uso do programa e termina
+ * o programa.
+ */
+static void usage(char *progname)
+{
+    fprintf(stderr, "Forma de uso: %s [ -b ] [ -f <m> ] [ -t ] [ -g ] [ -s <omega> ] [ -w <arq.bin> ] [ -i ] [ -r ] [ <sistema.bin> | < sistema.dat ]\n", progname);
+    fprintf(stderr, "              %s -p <n>\n", progname);
+    fprintf(stderr, "              %s -m < sistema.dat\n", progname);
+    fprintf(stderr, "              %s -l < sistemas.dat\n", progname);
+    fprintf(stderr, "  -b: resolve também com a fatoração LU em blocos\n");
+    fprintf(stderr, "  -f <m>: fatora uma vez e resolve 'm' lados direitos\n");
+    fprintf(stderr, "  -p <n>: compara trocas de linhas por cópia e por ponteiros\n");
+    fprintf(stderr, "  -m: mede a vazão [MB/s] da leitura do SL\n");
+    fprintf(stderr, "  -l: resolve em paralelo todos os SLs da entrada, em lotes\n");
+    fprintf(stderr, "  -w <arq.bin>: grava o SL lido no formato binário\n");
+    fprintf(stderr, "  -r: refina a solução da EG com os fatores LU\n");
+    fprintf(stderr, "  -i: resolve apenas com LU no próprio SL (sem cópias)\n");
+    fprintf(stderr, "  <sistema.bin>: lê o SL do arquivo binário, não da entrada padrão\n");
+    fprintf(stderr, "  -t: compara eliminação e LU seriais com as versões paralelas\n");
+    fprintf(stderr, "  -g: resolve também com Gauss-Seidel em blocos paralelo\n");
+    fprintf(stderr, "  -s <omega>: resolve também com SOR (omega <= 0: estimado)\n");
+    exit(1);
+}
+
+/**
+ * Fatora 'SL' uma vez e resolve 'm' lados direitos: b, 2b, ..., m*b.
+ * Mostra tempo de fatoração, tempo e vazão [lados/s] das soluções uma a
+ * uma e em bloco, e solução e resíduo do primeiro lado direito.
+ */
+static void perfFatLU(SistLinear_t *SL, int m)
+{
+    int n = SL->n;
+    real_t *X = (real_t *) malloc(n * sizeof(real_t));
+    real_t *R = (real_t *) malloc(n * sizeof(real_t));
+    real_t *b = (real_t *) malloc(n * sizeof(real_t));
+    real_t **B = (real_t **) malloc(n * sizeof(real_t *));
+
+    if (!X || !R || !b || !B || !(B[0] = (real_t *) malloc((size_t) n * m * sizeof(real_t)))) {
+        fprintf(stderr, "Erro de alocação de memória.\n");
+        exit(-1);
+    }
+    for (int i = 1; i < n; ++i)
+        B[i] = B[i-1] + m;
+    for (int i = 0; i < n; ++i)
+        for (int r = 0; r < m; ++r)
+            B[i][r] = SL->b[i] * (r + 1);
+
+    rtime_t tempo_f = timestamp();
+    LIKWID_MARKER_START("Fatoracao-LU");
+    FatLU_t *F = fatoraLU(SL);
+    LIKWID_MARKER_STOP("Fatoracao-LU");
+    tempo_f = timestamp() - tempo_f;
+
+    if (!F) {
+        fprintf(stderr, "Fatoração LU: matriz singular.\n");
+        exit(-1);
+    }
+
+    rtime_t tempo_1 = timestamp();
+    LIKWID_MARKER_START("Solucao-LU");
+    for (int r = 0; r < m; ++r) {
+        for (int i = 0; i < n; ++i)
+            b[i] = SL->b[i] * (r + 1);
+        resolveLU(F, b, X);
+    }
+    LIKWID_MARKER_STOP("Solucao-LU");
+    tempo_1 = timestamp() - tempo_1;
+
+    rtime_t tempo_m = timestamp();
+    LIKWID_MARKER_START("Solucao-LU-Mult");
+    resolveLUMult(F, B, m);
+    LIKWID_MARKER_STOP("Solucao-LU-Mult");
+    tempo_m = timestamp() - tempo_m;
+
+    resolveLU(F, SL->b, X);
+    residuo(SL, X, R, n);
+
+    printf("LU [ %d lados direitos ]:\n", m);
+    printf("fatoração: %.8f ms\n", tempo_f);
+    printf("resolveLU: %.8f ms (%.2f lados/s)\n", tempo_1, m / (tempo_1 * 1.0e-3));
+    printf("resolveLUMult: %.8f ms (%.2f lados/s)\n", tempo_m, m / (tempo_m * 1.0e-3));
+    prnVetor(X, n);
+    prnVetor(R, n);
+    printf("\n");
+
+    liberaFatLU(F);
+    free(B[0]);
+    free(B);
+    free(b);
+    free(R);
+    free(X);
+}
+
+/**
+ * Refina 'x_eg', solução de 'SL' pela Eliminação de Gauss, com
+ * 'refinaLU()' sobre 'F', a fatoração que produziu 'x_eg': nenhuma
+ * fatoração extra, só O(n²) por correção. Mostra tempo de refinamento,
+ * número de correções, redução da norma do resíduo, e solução e resíduo
+ * refinados.
+ */
+static void perfRefino(SistLinear_t *SL, FatLU_t *F, real_t *x_eg)
+{
+    int n = SL->n;
+    real_t *X = (real_t *) malloc(n * sizeof(real_t));
+    real_t *R = (real_t *) malloc(n * sizeof(real_t));
+
+    if (!X || !R) {
+        fprintf(stderr, "Erro de alocação de memória.\n");
+        exit(-1);
+    }
+
+    real_t normaIni, normaFim;
+    for (int i = 0; i < n; ++i)
+        X[i] = x_eg[i];
+
+    rtime_t tempo_r = timestamp();
+    LIKWID_MARKER_START("Refinamento");
+    int it = refinaLU(F, SL, X, REFINA_MAXIT, &normaIni, &normaFim);
+    LIKWID_MARKER_STOP("Refinamento");
+    tempo_r = timestamp() - tempo_r;
+
+    if (it < 0) {
+        fprintf(stderr, "Erro de alocação de memória.\n");
+        exit(-1);
+    }
+
+    residuo(SL, X, R, n);
+
+    printf("EG refinada [ %d correções, resíduo %g -> %g (%.3g vezes menor) ]:\n",
+           it, normaIni, normaFim, (normaFim > 0.0) ? normaIni / normaFim : INFINITY);
+    printf("refinamento: %.8f ms\n", tempo_r);
+    prnVetor(X, n);
+    prnVetor(R, n);
+    printf("\n");
+
+    free(X);
+    free(R);
+}
+
+// SLs lidos antes de cada rodada paralela do modo '-l'
+#define TAM_LOTE 64
+
+// SL de um lote e seus vetores de trabalho, reaproveitados entre lotes
+typedef struct {
+    SistLinear_t *SL;
+    real_t *X, *R;
+    int *piv;
+    unsigned int cap; // ordem comportada por 'X', 'R' e 'piv'
+    rtime_t tempo;
+    int ret;          // 0, LU_SINGULAR ou LU_SEM_MEMORIA
+} ItemLote_t;
+
+/* Resolve o SL de 'it' com a LU em blocos no próprio SL (como no modo
+   '-i') e calcula o resíduo dos fatores ('residuoLU()') */
+static void resolveItemLote(ItemLote_t *it)
+{
+    SistLinear_t *SL = it->SL;
+    int n = SL->n;
+
+    it->tempo = timestamp();
+    it->ret = fatoraLUBlocado(SL->A, n, it->piv);
+    if (!it->ret)
+        substLU(SL->A, n, it->piv, SL->b, it->X);
+    it->tempo = timestamp() - it->tempo;
+
+    if (!it->ret && residuoLU(SL->A, n, it->piv, SL->b, it->X, it->R))
+        it->ret = LU_SEM_MEMORIA;
+}
+
+/**
+ * Resolve todos os SLs da entrada padrão, até o fim: lê TAM_LOTE SLs,
+ * resolve-os em paralelo (um SL por thread, escalonamento dinâmico) e
+ * mostra os resultados na ordem da entrada, com o resíduo dos fatores
+ * (como em 'perfNoLugar()'). SLs e vetores de cada posição
+ * do lote são reaproveitados ('lerSisLinReusa()'), e só são realocados
+ * quando chega um SL de ordem maior que todas as anteriores na posição.
+ * Um SL mal formado interrompe a leitura: os SLs anteriores são mostrados
+ * e o índice do SL inválido vai para a saída de erro.
+ * Retorna 0 se a entrada foi lida até o fim, ou -1.
+ */
+static int perfLote(void)
+{
+    ItemLote_t lote[TAM_LOTE];
+    int total = 0, fim = 0;
+    leitura_t sit = leituraOk;
+
+    memset(lote, 0, sizeof(lote));
+
+    rtime_t tempo = timestamp();
+    LIKWID_MARKER_START("Lote");
+    while (!fim) {
+        int m;
+
+        for (m = 0; m < TAM_LOTE; ++m) {
+            ItemLote_t *it = &lote[m];
+            SistLinear_t *SL = lerSisLinReusa(it->SL, &sit);
+
+            if (!SL) {
+                fim = 1;
+                break;
+            }
+            it->SL = SL;
+
+            if (SL->n > it->cap) {
+                free(it->X);
+                free(it->R);
+                free(it->piv);
+                it->X = (real_t *) malloc(SL->n * sizeof(real_t));
+                it->R = (real_t *) malloc(SL->n * sizeof(real_t));
+                it->piv = (int *) malloc(SL->n * sizeof(int));
+                if (!it->X || !it->R || !it->piv) {
+                    fprintf(stderr, "Erro de alocação de memória.\n");
+                    exit(-1);
+                }
+                it->cap = SL->n;
+            }
+        }
+
+#pragma omp parallel for schedule(dynamic, 1)
+        for (int k = 0; k < m; ++k)
+            resolveItemLote(&lote[k]);
+
+        for (int k = 0; k < m; ++k) {
+            ItemLote_t *it = &lote[k];
+
+            if (it->ret == LU_SEM_MEMORIA) {
+                fprintf(stderr, "Erro de alocação de memória.\n");
+                exit(-1);
+            }
+            if (it->ret) {
+                printf("SL %d [ n = %u ]: matriz singular.\n\n", total + k, it->SL->n);
+                continue;
+            }
+            printf("SL %d [ n = %u, resíduo dos fatores ]:\n", total + k, it->SL->n);
+            printf("%.8f ms\n", it->tempo);
+            prnVetor(it->X, it->SL->n);
+            prnVetor(it->R, it->SL->n);
+            printf("\n");
+        }
+        total += m;
+    }
+    LIKWID_MARKER_STOP("Lote");
+    tempo = timestamp() - tempo;
+
+    printf("Lote: %d SLs em %.8f ms (%.2f SLs/s)\n", total, tempo,
+           total / (tempo * 1.0e-3));
+
+    // Não há como ressincronizar com o SL seguinte: interrompe o lote
+    if (sit != leituraFim)
+        fprintf(stderr, "SL %d: %s; SLs seguintes não processados.\n", total,
+                sit == leituraSemMemoria ? "erro de alocação de memória" : "entrada inválida");
+
+    for (int k = 0; k < TAM_LOTE; ++k) {
+        liberaSisLin(lote[k].SL);
+        free(lote[k].X);
+        free(lote[k].R);
+        free(lote[k].piv);
+    }
+
+    return (sit == leituraFim) ? 0 : -1;
+}
+
+// Métodos diretos comparados por 'perfParalelo()'
+typedef enum { egSerial = 0, egPar, luSerial, luTarefas, NUM_DIRETOS } direto_t;
+
+static const char *nomeDireto[NUM_DIRETOS] = {
+    "EG-Serial", "EG-Paralela", "LU-Blocado", "LU-Tarefas"
+};
+
+/**
+ * Resolve 'SL' com a Eliminação de Gauss serial e paralela
+ * ('retrosubstPar()') e com a LU em blocos serial e como grafo de tarefas
+ * ('retrosubstTarefas()'), cada uma sob seu marcador LIKWID. Mostra tempo,
+ * maior diferença para a solução da EG serial e resíduo de cada método.
+ */
+static void perfParalelo(SistLinear_t *SL)
+{
+    int n = SL->n;
+    real_t *X[NUM_DIRETOS];
+    real_t *R = (real_t *) malloc(n * sizeof(real_t));
+
+    for (direto_t d = egSerial; d < NUM_DIRETOS; ++d) {
+        SistLinear_t *C = dupSisLin(SL);
+        X[d] = (real_t *) calloc(n, sizeof(real_t));
+        if (!C || !X[d] || !R || materializaSisLin(C)) {
+            fprintf(stderr, "Erro de alocação de memória.\n");
+            exit(-1);
+        }
+
+        int ret = 0;
+        rtime_t tempo = timestamp();
+        LIKWID_MARKER_START(nomeDireto[d]);
+        switch (d) {
+        case egSerial:  ret = retrosubst(C, X[d]) ? LU_SEM_MEMORIA : 0; break;
+        case egPar:     ret = retrosubstPar(C, X[d]) ? LU_SEM_MEMORIA : 0; break;
+        case luSerial:  ret = retrosubstBlocado(C, X[d]); break;
+        case luTarefas: ret = retrosubstTarefas(C, X[d]); break;
+        default: break;
+        }
+        LIKWID_MARKER_STOP(nomeDireto[d]);
+        tempo = timestamp() - tempo;
+
+        if (ret == LU_SEM_MEMORIA) {
+            fprintf(stderr, "Erro de alocação de memória.\n");
+            exit(-1);
+        }
+        if (ret == LU_SINGULAR) {
+            printf("%s: matriz singular.\n\n", nomeDireto[d]);
+            liberaSisLin(C);
+            continue;
+        }
+
+        real_t rMax, rL2 = residuoNormas(SL, X[d], R, n, &rMax);
+        printf("%s [ dif. EG = %g, resíduo = %g, máx = %g ]:\n", nomeDireto[d],
+               fabs(normaMax(X[d], X[egSerial], n)), rL2, rMax);
+        printf("%.8f ms\n\n", tempo);
+
+        liberaSisLin(C);
+    }
+
+    for (direto_t d = egSerial; d < NUM_DIRETOS; ++d)
+        free(X[d]);
+    free(R);
+}
+
+/**
+ * Resolve 'SL' com a LU em blocos no próprio SL, sem cópia da matriz: o
+ * pico de memória é de uma matriz. Como A é destruída, o resíduo mostrado
+ * é o dos fatores ('residuoLU()'), e não b - A*x: mede o arredondamento
+ * das substituições, não a qualidade da fatoração.
+ */
+static void perfNoLugar(SistLinear_t *SL)
+{
+    int n = SL->n;
+    int *piv = (int *) malloc(n * sizeof(int));
+    real_t *X = (real_t *) malloc(n * sizeof(real_t));
+    real_t *R = (real_t *) malloc(n * sizeof(real_t));
+
+    if (!piv || !X || !R || materializaSisLin(SL)) {
+        fprintf(stderr, "Erro de alocação de memória.\n");
+        exit(-1);
+    }
+
+    rtime_t tempo = timestamp();
+    LIKWID_MARKER_START("LU-No-Lugar");
+    int ret = fatoraLUBlocado(SL->A, n, piv);
+    if (!ret)
+        substLU(SL->A, n, piv, SL->b, X);
+    LIKWID_MARKER_STOP("LU-No-Lugar");
+    tempo = timestamp() - tempo;
+
+    if (ret) {
+        fprintf(stderr, "LU no lugar: matriz singular.\n");
+        exit(-1);
+    }
+
+    if (residuoLU(SL->A, n, piv, SL->b, X, R)) {
+        fprintf(stderr, "Erro de alocação de memória.\n");
+        exit(-1);
+    }
+
+    printf("LU no lugar [ resíduo dos fatores: b - P^T*L*U*x ]:\n");
+    printf("%.8f ms\n", tempo);
+    prnVetor(X, n);
+    prnVetor(R, n);
+
+    free(piv);
+    free(X);
+    free(R);
+}
+
+/**
+ * Mede a vazão da leitura do SL da entrada padrão com 'lerSisLin()'. Se a
+ * entrada é um arquivo regular, relê com 'lerSisLinScanf()' e mostra a
+ * vazão da leitura com 'scanf()' e quantos valores diferem.
+ */
+static void perfLeitura(void)
+{
+    struct stat st;
+    int arquivo = (fstat(STDIN_FILENO, &st) == 0 && S_ISREG(st.st_mode));
+
+    rtime_t tempo = timestamp();
+    SistLinear_t *SL = lerSisLin();
+    tempo = timestamp() - tempo;
+
+    if (!SL) {
+        fprintf(stderr, "Erro ao ler o sistema linear.\n");
+        exit(-1);
+    }
+
+    printf("Leitura [ n = %d ]:\n", SL->n);
+    if (!arquivo) {
+        printf("lerSisLin: %.8f ms\n", tempo);
+        liberaSisLin(SL);
+        return;
+    }
+
+    double mb = st.st_size / 1.0e6;
+    printf("lerSisLin: %.8f ms (%.2f MB/s)\n", tempo, mb / (tempo * 1.0e-3));
+
+    lseek(STDIN_FILENO, 0, SEEK_SET);
+    tempo = timestamp();
+    SistLinear_t *SLs = lerSisLinScanf();
+    tempo = timestamp() - tempo;
+
+    if (SLs) {
+        long dif = 0;
+        for (int i = 0; i < SL->n; ++i) {
+            for (int j = 0; j < SL->n; ++j)
+                dif += (SL->A[i][j] != SLs->A[i][j]);
+            dif += (SL->b[i] != SLs->b[i]);
+        }
+        printf("lerSisLinScanf: %.8f ms (%.2f MB/s)\n", tempo, mb / (tempo * 1.0e-3));
+        printf("valores diferentes: %ld\n", dif);
+        liberaSisLin(SLs);
+    }
+
+    liberaSisLin(SL);
+}
+
+/**
+ * Triangulariza o mesmo SL aleatório 'n x n' trocando linhas por cópia
+ * ('triangularizaCopia()') e por troca de ponteiros ('triangulariza()').
+ * Mostra tempos e o volume de memória movido pelas cópias de linhas
+ * (leitura e escrita das duas linhas em cada troca).
+ */
+static void perfPivo(int n)
+{
+    srand(20232);
+    SistLinear_t *s_orig = geraSisLin(n, 0);
+    SistLinear_t *s_cp = s_orig ? dupSisLin(s_orig) : NULL;
+
+    if (!s_cp || materializaSisLin(s_cp)) {
+        fprintf(stderr, "Erro de alocação de memória.\n");
+        exit(-1);
+    }
+
+    rtime_t tempo_cp = timestamp();
+    LIKWID_MARKER_START("Pivo-Copia");
+    int trocas = triangularizaCopia(s_cp);
+    LIKWID_MARKER_STOP("Pivo-Copia");
+    tempo_cp = timestamp() - tempo_cp;
+
+    rtime_t tempo_pt = timestamp();
+    LIKWID_MARKER_START("Pivo-Ponteiro");
+    int ret = triangulariza(s_orig);
+    LIKWID_MARKER_STOP("Pivo-Ponteiro");
+    tempo_pt = timestamp() - tempo_pt;
+
+    if (trocas < 0 || ret < 0) {
+        fprintf(stderr, "Erro de alocação de memória.\n");
+        exit(-1);
+    }
+
+    printf("Pivoteamento [ n = %d, %d trocas ]:\n", n, trocas);
+    printf("cópia: %.8f ms (%.2f MB copiados)\n", tempo_cp,
+           4.0 * trocas * n * sizeof(real_t) / 1.0e6);
+    printf("ponteiros: %.8f ms (0 MB copiados)\n", tempo_pt);
+
+    liberaSisLin(s_cp);
+    liberaSisLin(s_orig);
+}
+
+/**
+ * Programa principal
+ * Forma de uso: perfSL [ -b ] [ -f <m> ] [ -t ] [ -g ] [ -s <omega> ] [ -w <arq.bin> ] [ -i ] [ -r ]
+ *                      [ <sistema.bin> | < sistema.dat ]
+ * Sem opções: Eliminação de Gauss e Gauss-Seidel sobre o sistema lido.
+ * -b: acrescenta a fatoração LU em blocos ('retrosubstBlocado()'),
+ *     com a maior diferença para a solução da Eliminação de Gauss.
+ * -f <m>: acrescenta 'fatoraLU()' e resolve 'm' lados direitos (o 'b'
+ *     lido e múltiplos dele), com 'resolveLU()' um a um e com
+ *     'resolveLUMult()'. Reporta tempo de fatoração e vazão das soluções.
+ *
+ * -t: acrescenta a comparação das versões seriais e paralelas (OpenMP) da
+ *     Eliminação de Gauss e da LU em blocos ('perfParalelo()').
+ * -g: acrescenta Gauss-Seidel em blocos paralelo ('gaussSeidelBlocos()').
+ * -s <omega>: acrescenta SOR ('sor()') com fator 'omega', ou estimado
+ *     automaticamente se 'omega' <= 0, para comparar com Gauss-Seidel o
+ *     tempo até a tolerância.
+ * -w <arq.bin>: grava o SL lido em 'arq.bin' ('salvaSisLinBin()').
+ * -i: apenas a LU em blocos, fatorando o SL lido no lugar ('perfNoLugar()');
+ *     as demais opções de solução são ignoradas. O resíduo mostrado é o
+ *     dos fatores, não b - A*x.
+ * -r: EG feita como fatoração LU ('fatoraLU()') e refinamento iterativo da
+ *     solução com os mesmos fatores ('perfRefino()'): uma única fatoração,
+ *     resíduo compensado e correção em O(n²) por passo.
+ * <sistema.bin>: SL lido do arquivo no formato binário de 'CabecalhoSL_t',
+ *     mapeado sem cópias ('lerSisLinBin()'), em vez da entrada padrão.
+ *
+ * Forma de uso: perfSL -m < sistema.dat
+ * Mede a vazão da leitura do SL ('perfLeitura()').
+ *
+ * Forma de uso: perfSL -l < sistemas.dat
+ * Resolve todos os SLs da entrada, um após o outro até o fim, em lotes
+ * paralelos com memória reaproveitada ('perfLote()'). A saída segue a
+ * ordem da entrada; termina com erro se algum SL é mal formado.
+ *
+ * Forma de uso: perfSL -p <n>
+ * Não lê SL: compara as trocas de linhas da Eliminação de Gauss por cópia
+ * e por ponteiros em um SL aleatório de ordem 'n' ('perfPivo()').
+ */
+int main(int argc, char *argv[]) {
+
+    int blocado = 0, nLados = 0, nPivo = 0, paralelo = 0, gsBlocos = 0, usaSor = 0;
+    int leitura = 0, noLugar = 0, refino = 0, lote = 0, opt;
+    char *arqBin = NULL;
+    real_t omega = 0.0;
+
+    while ((opt = getopt(argc, argv, "bf:p:tgs:mw:irl")) != -1) {
+        switch (opt) {
+        case 'b':
+            blocado = 1;
+            break;
+        case 'f':
+            nLados = atoi(optarg);
+            if (nLados < 1)
+                usage(argv[0]);
+            break;
+        case 't':
+            paralelo = 1;
+            break;
+        case 'g':
+            gsBlocos = 1;
+            break;
+        case 's':
+            usaSor = 1;
+            omega = atof(optarg);
+            if (omega >= 2.0)
+                usage(argv[0]);
+            break;
+        case 'm':
+            leitura = 1;
+            break;
+        case 'l':
+            lote = 1;
+            break;
+        case 'w':
+            arqBin = optarg;
+            break;
+        case 'i':
+            noLugar = 1;
+            break;
+        case 'r':
+            refino = 1;
+            break;
+        case 'p':
+            nPivo = atoi(optarg);
+            if (nPivo < 2)
+                usage(argv[0]);
+            break;
+        default:
+            usage(argv[0]);
+        }
+    }
 
     LIKWID_MARKER_INIT;
 
+    if (nPivo) {
+        perfPivo(nPivo);
+        LIKWID_MARKER_CLOSE;
+        return 0;
+    }
+
     // Define o modo de arredondamento para baixo para todos os cálculos de ponto flutuante
     fesetround(FE_DOWNWARD);
 
-    // Lê o sistema linear da entrada padrão
-    SistLinear_t *s_orig = lerSisLin();
+    if (leitura) {
+        perfLeitura();
+        fesetround(FE_TONEAREST);
+        LIKWID_MARKER_CLOSE;
+        return 0;
+    }
+
+    if (lote) {
+        int ret = perfLote();
+        fesetround(FE_TONEAREST);
+        LIKWID_MARKER_CLOSE;
+        return ret;
+    }
+
+    // Lê o sistema linear do arquivo binário ou da entrada padrão
+    SistLinear_t *s_orig = (optind < argc) ? lerSisLinBin(argv[optind]) : lerSisLin();
     if (!s_orig) {
         fprintf(stderr, "Erro ao ler o sistema linear.\n");
         return -1;
     }
 
+    if (arqBin && salvaSisLinBin(s_orig, arqBin))
+        perror(arqBin);
+
+    if (noLugar) {
+        perfNoLugar(s_orig);
+        liberaSisLin(s_orig);
+        fesetround(FE_TONEAREST);
+        LIKWID_MARKER_CLOSE;
+        return 0;
+    }
+
     // Aloca vetores para as soluções e resíduos
     real_t *x_eg = (real_t *) calloc(s_orig->n, sizeof(real_t));
     real_t *r_eg = (real_t *) calloc(s_orig->n, sizeof(real_t));
@@ -38,25 +629,89 @@ int main() {
     }
 
     // --- Eliminação de Gauss ---
-    SistLinear_t *s_eg = dupSisLin(s_orig);
-    if (s_eg) {
+    // Com '-r', a EG é feita como fatoração LU ('fatoraLU()', mesmo
+    // pivoteamento parcial), e os fatores são reaproveitados pelo refinamento
+    SistLinear_t *s_eg = refino ? NULL : dupSisLin(s_orig);
+    FatLU_t *F = NULL;
+    if (refino || (s_eg && !materializaSisLin(s_eg))) {
+        int ret;
         rtime_t tempo_eg = timestamp();
         LIKWID_MARKER_START("Eliminação-de-Gauss");
-        retrosubst(s_eg, x_eg);
+        if (refino) {
+            F = fatoraLU(s_orig);
+            if (F)
+                resolveLU(F, s_orig->b, x_eg);
+            ret = F ? 0 : -1;
+        }
+        else
+            ret = retrosubst(s_eg, x_eg);
         LIKWID_MARKER_STOP("Eliminação-de-Gauss");
         tempo_eg = timestamp() - tempo_eg;
 
+        if (ret < 0) {
+            fprintf(stderr, refino ? "EG: matriz singular ou erro de alocação.\n"
+                                   : "Erro de alocação de memória.\n");
+            exit(-1);
+        }
+
         residuo(s_orig, x_eg, r_eg, s_orig->n);
 
-        printf("EG:\n");
+        printf(refino ? "EG (fatoração LU):\n" : "EG:\n");
         printf("%.8f ms\n", tempo_eg);
         prnVetor(x_eg, s_orig->n);
         prnVetor(r_eg, s_orig->n);
         printf("\n");
 
         liberaSisLin(s_eg);
+
+        if (refino) {
+            perfRefino(s_orig, F, x_eg);
+            liberaFatLU(F);
+        }
     }
 
+    // --- Fatoração LU em blocos ---
+    if (blocado) {
+        SistLinear_t *s_lu = dupSisLin(s_orig);
+        real_t *x_lu = (real_t *) calloc(s_orig->n, sizeof(real_t));
+        real_t *r_lu = (real_t *) calloc(s_orig->n, sizeof(real_t));
+
+        if (s_lu && x_lu && r_lu && !materializaSisLin(s_lu)) {
+            rtime_t tempo_lu = timestamp();
+            LIKWID_MARKER_START("LU-Blocado");
+            int ret = retrosubstBlocado(s_lu, x_lu);
+            LIKWID_MARKER_STOP("LU-Blocado");
+            tempo_lu = timestamp() - tempo_lu;
+
+            if (ret == LU_SEM_MEMORIA) {
+                fprintf(stderr, "Erro de alocação de memória.\n");
+                exit(-1);
+            }
+            if (ret)
+                fprintf(stderr, "LU em blocos: matriz singular.\n");
+
+            residuo(s_orig, x_lu, r_lu, s_orig->n);
+
+            printf("LU em blocos [ dif. EG = %g ]:\n", fabs(normaMax(x_lu, x_eg, s_orig->n)));
+            printf("%.8f ms\n", tempo_lu);
+            prnVetor(x_lu, s_orig->n);
+            prnVetor(r_lu, s_orig->n);
+            printf("\n");
+        }
+
+        liberaSisLin(s_lu);
+        free(x_lu);
+        free(r_lu);
+    }
+
+    // --- Fatoração LU reutilizável ---
+    if (nLados)
+        perfFatLU(s_orig, nLados);
+
+    // --- Versões paralelas ---
+    if (paralelo)
+        perfParalelo(s_orig);
+
     // --- Gauss-Seidel ---
     SistLinear_t *s_gs = dupSisLin(s_orig);
     if (s_gs) {
@@ -80,6 +735,57 @@ int main() {
         liberaSisLin(s_gs);
     }
 
+    // --- Gauss-Seidel em blocos paralelo ---
+    if (gsBlocos) {
+        real_t *y_gb = (real_t *) calloc(s_orig->n, sizeof(real_t));
+        real_t norma;
+
+        if (y_gb) {
+            rtime_t tempo_gb = timestamp();
+            LIKWID_MARKER_START("Gauss-Seidel-Blocos");
+            int it = gaussSeidelBlocos(s_orig, y_gb, TOL, MAXIT, &norma);
+            LIKWID_MARKER_STOP("Gauss-Seidel-Blocos");
+            tempo_gb = timestamp() - tempo_gb;
+
+            if (it == GS_SEM_MEMORIA) {
+                fprintf(stderr, "Erro de alocação de memória.\n");
+                exit(-1);
+            }
+
+            residuo(s_orig, y_gb, r_gs, s_orig->n);
+
+            printf("\nGS em blocos [ %d iterações, norma = %g ]:\n", it, norma);
+            printf("%.8f ms\n", tempo_gb);
+            prnVetor(y_gb, s_orig->n);
+            prnVetor(r_gs, s_orig->n);
+
+            free(y_gb);
+        }
+    }
+
+    // --- SOR ---
+    if (usaSor) {
+        real_t *y_sor = (real_t *) calloc(s_orig->n, sizeof(real_t));
+        real_t norma;
+
+        if (y_sor) {
+            rtime_t tempo_sor = timestamp();
+            LIKWID_MARKER_START("SOR");
+            int it = sor(s_orig, y_sor, TOL, MAXIT, &norma, &omega);
+            LIKWID_MARKER_STOP("SOR");
+            tempo_sor = timestamp() - tempo_sor;
+
+            residuo(s_orig, y_sor, r_gs, s_orig->n);
+
+            printf("\nSOR [ %d iterações, omega = %g, norma = %g ]:\n", it, omega, norma);
+            printf("%.8f ms\n", tempo_sor);
+            prnVetor(y_sor, s_orig->n);
+            prnVetor(r_gs, s_orig->n);
+
+            free(y_sor);
+        }
+    }
+
     // Libera toda a memória alocada
     liberaSisLin(s_orig);
     free(x_eg);
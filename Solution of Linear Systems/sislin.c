@@ -1,6 +1,13 @@
 #include <stdio.h>
 #include <math.h>
+#include <fenv.h>
 #include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <string.h>
+#include <limits.h>
 #include "utils.h"
 #include "sislin.h"
 
@@ -12,42 +19,308 @@ SistLinear_t* alocaSisLin (unsigned int n)
   if ( SL ) {
     
     SL->n = n;
+    SL->cap = n;
+    SL->mapa = NULL;
+    SL->tamMapa = 0;
     SL->A = (real_t **) calloc (n, sizeof(real_t *));
-    SL->A[0] = (real_t *) calloc (n*n, sizeof(real_t));
-    
-    for (int i=1; i < n; ++i)
-      SL->A[i] = SL->A[i-1]+n;
-	
+    SL->mem = (real_t *) calloc ((size_t) n*n, sizeof(real_t));
     SL->b = (real_t *) calloc (n, sizeof(real_t));
+    SL->refs = (int *) malloc (sizeof(int));
+    if (SL->refs)
+      *SL->refs = 1;
 
-    if (!(SL->A) || !(SL->b)) {
+    if (!(SL->A) || !(SL->mem) || !(SL->b) || !(SL->refs)) {
       liberaSisLin(SL);
       return NULL;
     }
+
+    for (int i=0; i < n; ++i)
+      SL->A[i] = SL->mem + (size_t) i*n;
   }
   
   return (SL);
 }
 
-// Liberacao de memória
+// Liberacao de memória. Os coeficientes só são liberados pelo último SL
+// que os compartilha
 void liberaSisLin (SistLinear_t *SL)
 {
   if (SL) {
-    if (SL->A) {
-      if (SL->A[0]) free (SL->A[0]);
-      free (SL->A);
-    }
+    if (SL->A) free (SL->A);
     if (SL->b) free(SL->b);
+    if (!SL->refs || --(*SL->refs) == 0) {
+      if (SL->mapa)
+	munmap(SL->mapa, SL->tamMapa);
+      else if (SL->mem)
+	free (SL->mem);
+      free(SL->refs);
+    }
     free(SL);
   }
 }
 
+// Entrada padrão inteira em memória: mapeada com mmap() se é arquivo
+// regular, ou lida em blocos com read(). 'pos' avança a cada número lido,
+// de forma que chamadas sucessivas de 'lerSisLin()' leem SLs consecutivos.
+static struct {
+  char *ini, *fim, *pos;
+  int carregada;
+} entrada;
+
+// Potências de 10 representáveis exatamente em double
+static const double pot10[] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+#define BLOCO_LEITURA (1 << 20)
+
+/* Carrega a entrada padrão em 'entrada'.
+   RETORNO: 0, ou -1 em caso de erro
+*/
+static int carregaEntrada (void)
+{
+  struct stat st;
+
+  entrada.carregada = 1;
+
+  if (fstat(STDIN_FILENO, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+    off_t ofs = lseek(STDIN_FILENO, 0, SEEK_CUR);
+    char *m = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, STDIN_FILENO, 0);
+    if (m != MAP_FAILED) {
+      madvise(m, st.st_size, MADV_SEQUENTIAL);
+      entrada.ini = m;
+      entrada.pos = m + (ofs > 0 ? ofs : 0);
+      entrada.fim = m + st.st_size;
+      return 0;
+    }
+  }
+
+  size_t tam = 0, cap = BLOCO_LEITURA;
+  char *buf = (char *) malloc(cap);
+  ssize_t lidos;
+
+  while (buf && (lidos = read(STDIN_FILENO, buf + tam, cap - tam)) > 0) {
+    tam += lidos;
+    if (tam == cap) {
+      char *novo = (char *) realloc(buf, cap *= 2);
+      if (!novo)
+	free(buf);
+      buf = novo;
+    }
+  }
+
+  if (!buf)
+    return -1;
+
+  entrada.ini = entrada.pos = buf;
+  entrada.fim = buf + tam;
+  return 0;
+}
+
+#define ESPACO(c) ((c) == ' ' || (c) == '\n' || (c) == '\t' || (c) == '\r' || (c) == '\v' || (c) == '\f')
+
+/* Lê o próximo número real de 'entrada'. Caminho rápido de Clinger: com
+   até 19 dígitos significativos, mantissa m <= 2^53 e |expoente| <= 22,
+   m e 10^|e| são exatos e o resultado m*10^e (ou m/10^|e|) tem um único
+   arredondamento, igual ao de 'strtod()' (inclusive no modo de
+   arredondamento corrente, pois o sinal é aplicado antes). Nos demais
+   casos o token (até o próximo espaço) é convertido com 'strtod()'.
+   RETORNO: 1 se leu um número, 0 no fim da entrada, -1 se token inválido
+*/
+static int leReal (real_t *x)
+{
+  char *p = entrada.pos, *fim = entrada.fim;
+
+  while (p < fim && ESPACO(*p))
+    ++p;
+  if (p == fim)
+    return 0;
+
+  char *token = p;
+  int neg = 0, dig = 0, sig = 0, exp10 = 0, rapido = 1;
+  unsigned long long m = 0;
+
+  if (*p == '-' || *p == '+')
+    neg = (*p++ == '-');
+
+  for (; p < fim && *p >= '0' && *p <= '9'; ++p, ++dig)
+    if (sig < 19) {
+      m = m*10 + (*p - '0');
+      sig += (m != 0);
+    }
+    else {
+      rapido &= (*p == '0');
+      ++exp10;
+    }
+
+  if (p < fim && *p == '.') {
+    for (++p; p < fim && *p >= '0' && *p <= '9'; ++p, ++dig)
+      if (sig < 19) {
+	m = m*10 + (*p - '0');
+	sig += (m != 0);
+	--exp10;
+      }
+      else
+	rapido &= (*p == '0');
+  }
+
+  if (dig && p < fim && (*p == 'e' || *p == 'E')) {
+    char *q = p + 1;
+    int negE = 0, e = 0;
+    if (q < fim && (*q == '-' || *q == '+'))
+      negE = (*q++ == '-');
+    if (q < fim && *q >= '0' && *q <= '9') {
+      for (; q < fim && *q >= '0' && *q <= '9'; ++q)
+	if (e < 100000)
+	  e = e*10 + (*q - '0');
+      exp10 += negE ? -e : e;
+      p = q;
+    }
+  }
+
+  if (dig && rapido && m <= (1ULL << 53) && exp10 >= -22 && exp10 <= 22
+      && (p == fim || ESPACO(*p))) {
+    real_t v = neg ? -(real_t) m : (real_t) m;
+    *x = (exp10 < 0) ? v / pot10[-exp10] : v * pot10[exp10];
+    entrada.pos = p;
+    return 1;
+  }
+
+  // Caminho lento: token inteiro copiado (a entrada não termina com '\0'),
+  // no heap se não cabe em 'buf'. Só é aceito se 'strtod()' o consome todo
+  char buf[128], *conv = buf, *fimConv;
+  size_t tam;
+
+  for (p = token; p < fim && !ESPACO(*p); ++p)
+    ;
+  tam = p - token;
+
+  if (tam >= sizeof(buf) && !(conv = (char *) malloc(tam + 1)))
+    return -1;
+  memcpy(conv, token, tam);
+  conv[tam] = '\0';
+
+  *x = strtod(conv, &fimConv);
+  int ok = (tam > 0 && fimConv == conv + tam);
+
+  if (conv != buf)
+    free(conv);
+  if (!ok)
+    return -1;
+
+  entrada.pos = p;
+  return 1;
+}
+
+/* Lê da entrada padrão um SL no formato
+     n
+     a11 a12 ... a1n b1
+     ...
+     an1 an2 ... ann bn
+   A entrada é carregada inteira na primeira chamada, e os coeficientes
+   são convertidos diretamente para o bloco contíguo 'SL->mem'.
+   RETORNO: SL lido, ou NULL no fim da entrada ou em caso de erro
+*/
 SistLinear_t *lerSisLin ()
+{
+  return lerSisLinReusa(NULL, NULL);
+}
+
+/* Lê a ordem 'n' do próximo SL da entrada: inteiro positivo.
+   RETORNO: situação da leitura
+*/
+static leitura_t leOrdem (unsigned int *n)
+{
+  real_t x;
+  int r;
+
+  if (!entrada.carregada && carregaEntrada())
+    return leituraSemMemoria;
+
+  if ((r = leReal(&x)) == 0)
+    return leituraFim;
+  if (r < 0 || x < 1.0 || x > UINT_MAX || x != floor(x))
+    return leituraInvalida;
+
+  *n = (unsigned int) x;
+  return leituraOk;
+}
+
+/* Lê os coeficientes e termos independentes de 'SL' (já com a ordem)
+   RETORNO: 0, ou -1 se há token inválido ou a entrada terminou antes
+*/
+static int leCoeficientes (SistLinear_t *SL)
+{
+  unsigned int n = SL->n;
+  real_t *a = SL->mem;
+
+  for(int i=0; i < n; ++i) {
+    for(int j=0; j < n; ++j)
+      if (leReal(a++) != 1)
+	return -1;
+    if (leReal(&SL->b[i]) != 1)
+      return -1;
+  }
+
+#ifdef __DEBUG__
+  printf ("\n\n");
+  prnSisLin(SL);
+#endif /* __DEBUG__ */
+
+  return 0;
+}
+
+/* Como 'lerSisLin()', mas reaproveita a memória de 'SL' (se != NULL) para
+   o próximo SL da entrada: se 'SL' é o único dono de seus coeficientes e
+   comporta a nova ordem, é reescrito; senão, é alocado um SL novo e 'SL'
+   liberado. Para ler uma sequência de SLs alocando só quando a ordem
+   cresce. Se 'sit' != NULL, recebe a situação da leitura, que distingue
+   o fim da entrada de um SL mal formado.
+   RETORNO: SL lido, ou NULL no fim da entrada ou em caso de erro ('SL'
+            continua válido e deve ser liberado por quem chamou)
+*/
+SistLinear_t *lerSisLinReusa (SistLinear_t *SL, leitura_t *sit)
+{
+  unsigned int n;
+  SistLinear_t *novo = NULL;
+  leitura_t r = leOrdem(&n);
+
+  if (r == leituraOk) {
+    if (SL && !SL->mapa && *SL->refs == 1 && SL->cap >= n) {
+      SL->n = n;
+      for (int i=0; i < n; ++i)
+	SL->A[i] = SL->mem + (size_t) i*n;
+      novo = SL;
+    }
+    else if (!(novo = alocaSisLin(n)))
+      r = leituraSemMemoria;
+  }
+
+  if (novo && leCoeficientes(novo)) {
+    if (novo != SL)
+      liberaSisLin(novo);
+    novo = NULL;
+    r = leituraInvalida;
+  }
+
+  if (SL && novo && novo != SL)
+    liberaSisLin(SL);
+
+  if (sit)
+    *sit = r;
+
+  return novo;
+}
+
+/* Leitura original, com 'scanf()': mantida para comparação */
+SistLinear_t *lerSisLinScanf ()
 {
   unsigned int n;
   SistLinear_t *SL;
   
-  scanf("%d",&n);
+  if (scanf("%u",&n) != 1)
+    return NULL;
 
   SL = alocaSisLin (n);
   
@@ -57,31 +330,222 @@ SistLinear_t *lerSisLin ()
     scanf ("%lg", &SL->b[i]);
   }
 
-#ifdef __DEBUG__
-  printf ("\n\n");
-  prnSisLin(SL);
-#endif /* __DEBUG__ */
-  
   return SL;
 }
 
+/* Grava 'SL' em 'arq' no formato binário de 'CabecalhoSL_t'.
+   A gravação é feita em um temporário no mesmo diretório, renomeado sobre
+   'arq' ao final: 'arq' pode ser o próprio arquivo mapeado por
+   'lerSisLinBin()', que não pode ser truncado enquanto em uso.
+   RETORNO: 0, ou -1 em caso de erro ('arq' fica intacto)
+*/
+int salvaSisLinBin (SistLinear_t *SL, const char *arq)
+{
+  CabecalhoSL_t cab;
+  char *tmp = (char *) malloc(strlen(arq) + sizeof(".XXXXXX"));
+  FILE *f = NULL;
+  mode_t mascara;
+  int fd, ok;
+
+  if (!tmp)
+    return -1;
+
+  sprintf(tmp, "%s.XXXXXX", arq);
+  if ((fd = mkstemp(tmp)) < 0) {
+    free(tmp);
+    return -1;
+  }
+
+  // mkstemp() cria com 0600: mesmas permissões de um fopen() comum
+  mascara = umask(0);
+  umask(mascara);
+  fchmod(fd, 0666 & ~mascara);
+
+  if (!(f = fdopen(fd, "wb"))) {
+    close(fd);
+    unlink(tmp);
+    free(tmp);
+    return -1;
+  }
+
+  memset(&cab, 0, sizeof(cab));
+  memcpy(cab.magico, SL_MAGICO, sizeof(SL_MAGICO));
+  cab.versao = SL_VERSAO;
+  cab.ordem = SL_ORDEM;
+  cab.n = SL->n;
+  cab.dtype = SL_DTYPE_F64;
+
+  ok = (fwrite(&cab, sizeof(cab), 1, f) == 1);
+  // Linha a linha: a ordem de 'A[i]' pode não ser a de 'mem'
+  for (int i=0; ok && i < SL->n; ++i)
+    ok = (fwrite(SL->A[i], sizeof(real_t), SL->n, f) == SL->n);
+  ok = ok && (fwrite(SL->b, sizeof(real_t), SL->n, f) == SL->n);
+  ok = (fclose(f) == 0) && ok;
+  ok = ok && (rename(tmp, arq) == 0);
+
+  if (!ok)
+    unlink(tmp);
+  free(tmp);
+
+  return ok ? 0 : -1;
+}
+
+/* Lê SL do arquivo binário 'arq' sem cópias: o arquivo é mapeado com
+   mmap() privado, e 'SL->mem' e 'SL->b' apontam para o mapeamento.
+   Páginas só são copiadas (pelo sistema) se o SL for alterado, e as
+   alterações não chegam ao arquivo.
+   RETORNO: SL lido, ou NULL se o arquivo é inválido ou em caso de erro
+*/
+SistLinear_t *lerSisLinBin (const char *arq)
+{
+  CabecalhoSL_t cab;
+  struct stat st;
+  int fd = open(arq, O_RDONLY);
+
+  if (fd < 0)
+    return NULL;
+
+  if (fstat(fd, &st) || read(fd, &cab, sizeof(cab)) != sizeof(cab)
+      || memcmp(cab.magico, SL_MAGICO, sizeof(SL_MAGICO))
+      || cab.versao != SL_VERSAO || cab.ordem != SL_ORDEM
+      || cab.dtype != SL_DTYPE_F64 || cab.n < 1
+      || st.st_size != sizeof(cab) + (cab.n * cab.n + cab.n) * sizeof(real_t)) {
+    close(fd);
+    return NULL;
+  }
+
+  void *m = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (m == MAP_FAILED)
+    return NULL;
+
+  SistLinear_t *SL = (SistLinear_t *) calloc(1, sizeof(SistLinear_t));
+  unsigned int n = cab.n;
+
+  if (SL) {
+    SL->A = (real_t **) malloc(n * sizeof(real_t *));
+    SL->b = (real_t *) malloc(n * sizeof(real_t));
+    SL->refs = (int *) malloc(sizeof(int));
+  }
+  if (!SL || !SL->A || !SL->b || !SL->refs) {
+    if (SL) {
+      free(SL->A);
+      free(SL->b);
+      free(SL->refs);
+      free(SL);
+    }
+    munmap(m, st.st_size);
+    return NULL;
+  }
+
+  SL->n = n;
+  SL->cap = n;
+  SL->mapa = m;
+  SL->tamMapa = st.st_size;
+  *SL->refs = 1;
+  SL->mem = (real_t *) ((char *) m + sizeof(cab));
+  for (int i=0; i < n; ++i)
+    SL->A[i] = SL->mem + (size_t) i*n;
+  // 'b' é pequeno e sempre privado de cada SL (ver 'dupSisLin()')
+  memcpy(SL->b, SL->mem + (size_t) n*n, n * sizeof(real_t));
+
+  return SL;
+}
+
+/* Duplica 'src' com cópia na escrita: 'dest' compartilha os coeficientes
+   de 'src' ('mem', contador 'refs'), e só copia os vetores de ponteiros de
+   linhas e 'b', em O(n). Quem for alterar 'A' deve antes chamar
+   'materializaSisLin()'.
+*/
 SistLinear_t *dupSisLin (SistLinear_t *src)
 {
   int n = src->n;
   
-  SistLinear_t *dest = alocaSisLin (n);
+  SistLinear_t *dest = (SistLinear_t *) malloc(sizeof(SistLinear_t));
 
   if (dest) {
-    for(int i=0; i < n; ++i) {
-      for(int j=0; j < n; ++j)
-	      dest->A[i][j] = src->A[i][j];
-      dest->b[i] = src->b[i];
+    *dest = *src;
+    dest->A = (real_t **) malloc(n * sizeof(real_t *));
+    dest->b = (real_t *) malloc(n * sizeof(real_t));
+    if (!dest->A || !dest->b) {
+      free(dest->A);
+      free(dest->b);
+      free(dest);
+      return NULL;
     }
+
+    memcpy(dest->A, src->A, n * sizeof(real_t *));
+    memcpy(dest->b, src->b, n * sizeof(real_t));
+    ++(*dest->refs);
   }
   
   return dest;
 }
 
+/* Garante que 'SL' é o único dono de seus coeficientes antes de
+   alterá-los: se 'mem' é compartilhado, copia as linhas (na ordem de
+   'A') para um bloco novo com 'memcpy()'. Sem compartilhamento, não faz
+   nada.
+   RETORNO: 0, ou -1 em caso de falha de alocação
+*/
+int materializaSisLin (SistLinear_t *SL)
+{
+  int n = SL->n;
+
+  if (*SL->refs == 1)
+    return 0;
+
+  real_t *mem = (real_t *) malloc((size_t) n*n * sizeof(real_t));
+  int *refs = (int *) malloc(sizeof(int));
+
+  if (!mem || !refs) {
+    free(mem);
+    free(refs);
+    return -1;
+  }
+
+  for (int i=0; i < n; ++i) {
+    memcpy(mem + (size_t) i*n, SL->A[i], n * sizeof(real_t));
+    SL->A[i] = mem + (size_t) i*n;
+  }
+
+  --(*SL->refs);
+  SL->refs = refs;
+  *SL->refs = 1;
+  SL->mem = mem;
+  SL->cap = n;
+  SL->mapa = NULL;
+  SL->tamMapa = 0;
+
+  return 0;
+}
+
+/* Gera SL 'n x n' com coeficientes e termos independentes aleatórios em
+   [-1,1] (usa 'rand()'). Se 'diagDominante', A[i][i] recebe a soma dos
+   módulos da linha mais 1, e o SL é estritamente diagonal dominante.
+*/
+SistLinear_t *geraSisLin (unsigned int n, int diagDominante)
+{
+  SistLinear_t *SL = alocaSisLin (n);
+
+  if (SL) {
+    real_t escala = 2.0 / (real_t) RAND_MAX;
+
+    for(int i=0; i < n; ++i) {
+      real_t soma = 0.0;
+      for(int j=0; j < n; ++j) {
+	SL->A[i][j] = rand() * escala - 1.0;
+	soma += ABS(SL->A[i][j]);
+      }
+      SL->b[i] = rand() * escala - 1.0;
+      if (diagDominante)
+	SL->A[i][i] = soma + 1.0;
+    }
+  }
+
+  return SL;
+}
+
 void prnSisLin (SistLinear_t *SL)
 {
   int n=SL->n;
@@ -118,26 +582,220 @@ real_t normaMax(real_t *X1, real_t *X0, int n)
   return norma;
 }
 
+/* Soma compensada (Neumaier) de 'n' valores, na ordem dada */
+static real_t somaComp(real_t *v, real_t *c, int n)
+{
+  real_t s = 0.0, e = 0.0;
+
+  for (int i=0; i < n; ++i) {
+    real_t t = s + v[i];
+    e += (ABS(s) >= ABS(v[i])) ? (s - t) + v[i] : (v[i] - t) + s;
+    s = t;
+    e += c[i];
+  }
+
+  return s + e;
+}
+
+/* Soma de quadrados compensada das linhas [ini, fim) de 'X': 'X[i]*X[i]'
+   é separado em produto e erro exato com 'fma()' (TwoProduct) */
+static void quadradosComp(real_t *X, int ini, int fim, real_t *s, real_t *c)
+{
+  real_t sq = 0.0, e = 0.0;
+
+  for (int i=ini; i < fim; ++i) {
+    real_t p = X[i]*X[i];
+    real_t t = sq + p;
+    e += fma(X[i], X[i], -p) + ((sq >= p) ? (sq - t) + p : (p - t) + sq);
+    sq = t;
+  }
+
+  *s = sq;
+  *c = e;
+}
+
 // Calcula a norma euclidiana de um vetor
+// Soma compensada por blocos de RES_BLOCO elementos, com os blocos somados
+// na mesma ordem qualquer que seja o número de threads
 real_t normaL2(real_t *X, int n)
 {
-
+  int nBlocos = (n + RES_BLOCO - 1) / RES_BLOCO;
+  real_t *parc = (real_t *) malloc(2 * nBlocos * sizeof(real_t));
   real_t norma = 0.0;
 
-  for (int i=0; i < n; ++i)
-    norma += X[i]*X[i];
+  if (!parc) {
+    for (int i=0; i < n; ++i)
+      norma += X[i]*X[i];
+    return sqrt(norma);
+  }
+
+#pragma omp parallel for schedule(static) if (n >= RES_PAR_MIN)
+  for (int k=0; k < nBlocos; ++k)
+    quadradosComp(X, k*RES_BLOCO, MIN((k+1)*RES_BLOCO, n), &parc[k], &parc[nBlocos + k]);
+
+  norma = somaComp(parc, parc + nBlocos, nBlocos);
+  free(parc);
 
   return sqrt(norma);
 }
 
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+
+// Passo do Dot2 em 4 vias: s += a*x, com os erros de produto e de soma
+// acumulados em c
+static inline void dot2Passo(__m256d a, __m256d x, __m256d *s, __m256d *c)
+{
+  __m256d p = _mm256_mul_pd(a, x);
+  __m256d ep = _mm256_fmsub_pd(a, x, p);
+  __m256d t = _mm256_add_pd(*s, p);
+  __m256d z = _mm256_sub_pd(t, *s);
+  __m256d es = _mm256_add_pd(_mm256_sub_pd(*s, _mm256_sub_pd(t, z)), _mm256_sub_pd(p, z));
+  *c = _mm256_add_pd(*c, _mm256_add_pd(es, ep));
+  *s = t;
+}
+
+// Acumula a[j]*X[j], j < nv (múltiplo de RES_VIAS), nas RES_VIAS vias
+// de 's' e 'c'. Intrínsecos porque, com -frounding-math, o compilador
+// não vetoriza 'fma()'
+static void dot2Vias(real_t *a, real_t *X, int nv, real_t *s, real_t *c)
+{
+  __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+  __m256d c0 = _mm256_setzero_pd(), c1 = _mm256_setzero_pd();
+
+  for (int j=0; j < nv; j += RES_VIAS) {
+    dot2Passo(_mm256_loadu_pd(a+j), _mm256_loadu_pd(X+j), &s0, &c0);
+    dot2Passo(_mm256_loadu_pd(a+j+4), _mm256_loadu_pd(X+j+4), &s1, &c1);
+  }
+
+  _mm256_storeu_pd(s, s0);
+  _mm256_storeu_pd(s+4, s1);
+  _mm256_storeu_pd(c, c0);
+  _mm256_storeu_pd(c+4, c1);
+}
+#else
+// Versão escalar, mesmas operações da versão AVX2
+static void dot2Vias(real_t *a, real_t *X, int nv, real_t *s, real_t *c)
+{
+  for (int l=0; l < RES_VIAS; ++l)
+    s[l] = c[l] = 0.0;
+
+  for (int j=0; j < nv; j += RES_VIAS)
+    for (int l=0; l < RES_VIAS; ++l) {
+      real_t p = a[j+l] * X[j+l];
+      real_t ep = fma(a[j+l], X[j+l], -p);
+      real_t t = s[l] + p;
+      real_t z = t - s[l];
+      c[l] += ((s[l] - (t - z)) + (p - z)) + ep;
+      s[l] = t;
+    }
+}
+#endif
+
+/* Resíduo da linha 'a' com produto escalar compensado (Dot2, Ogita, Rump e
+   Oishi 2005): RES_VIAS acumuladores independentes, cada um com TwoProduct
+   ('fma()') e TwoSum.
+   RETORNO: b - a.X com erro da ordem de um arredondamento do resultado
+*/
+static real_t residuoLinha(real_t *a, real_t *X, real_t b, int n)
+{
+  real_t s[RES_VIAS], c[RES_VIAS];
+  int j = n - n % RES_VIAS;
+
+  dot2Vias(a, X, j, s, c);
+
+  for (; j < n; ++j) {
+    real_t p = a[j] * X[j];
+    real_t t = s[0] + p;
+    real_t z = t - s[0];
+    c[0] += ((s[0] - (t - z)) + (p - z)) + fma(a[j], X[j], -p);
+    s[0] = t;
+  }
+
+  // b - soma: com resíduo pequeno, b e soma são próximos e a subtração do
+  // termo principal é quase exata; os erros acumulados entram no fim
+  real_t r = b, e = 0.0;
+  for (int l=0; l < RES_VIAS; ++l) {
+    real_t t = r - s[l];
+    e += (ABS(r) >= ABS(s[l])) ? (r - t) - s[l] : (-s[l] - t) + r;
+    r = t;
+    e -= c[l];
+  }
+
+  return r + e;
+}
+
+/* Calcula o resíduo R = b - AX e suas normas em uma só passada sobre A.
+   Linhas distribuídas entre threads em blocos de RES_BLOCO; as somas de
+   cada bloco são combinadas em ordem fixa, então o resultado independe
+   do número de threads. As transformações sem erro (TwoSum/TwoProduct)
+   exigem arredondamento ao mais próximo, que é ativado localmente em cada
+   thread e restaurado ao final.
+   Vetor *R já deve ter sido alocado previamente.
+   @param nMax se != NULL, recebe a norma máxima de R
+   RETORNO: norma euclidiana de R
+*/
+real_t residuoNormas(SistLinear_t *SL, real_t *X, real_t *R, int n, real_t *nMax)
+{
+  int nBlocos = (n + RES_BLOCO - 1) / RES_BLOCO;
+  real_t *parc = (real_t *) malloc(2 * nBlocos * sizeof(real_t));
+  real_t maximo = 0.0, norma;
+
+  if (!parc) {
+    // Sem as parcelas por bloco: mesmas normas, calculadas sobre R pronto
+    residuo(SL, X, R, n);
+    for (int i=0; i < n; ++i)
+      if (fabs(R[i]) > maximo)
+        maximo = fabs(R[i]);
+    if (nMax)
+      *nMax = maximo;
+    return normaL2(R, n);
+  }
+
+#pragma omp parallel if (n >= RES_PAR_MIN) reduction(max: maximo)
+  {
+    int modo = fegetround();
+    fesetround(FE_TONEAREST);
+
+#pragma omp for schedule(static)
+    for (int k=0; k < nBlocos; ++k) {
+      int ini = k*RES_BLOCO, fim = MIN(ini + RES_BLOCO, n);
+
+      for (int i=ini; i < fim; ++i) {
+        R[i] = residuoLinha(SL->A[i], X, SL->b[i], n);
+        if (fabs(R[i]) > maximo)
+          maximo = fabs(R[i]);
+      }
+      quadradosComp(R, ini, fim, &parc[k], &parc[nBlocos + k]);
+    }
+
+    fesetround(modo);
+  }
+
+  norma = sqrt(somaComp(parc, parc + nBlocos, nBlocos));
+  free(parc);
+
+  if (nMax)
+    *nMax = maximo;
+
+  return norma;
+}
 /* Calcula o resíduo R de um sistema AX = B
+   Cada linha com produto escalar compensado ('residuoLinha()'); use
+   'residuoNormas()' quando as normas de R também forem necessárias.
    Vetor *R já deve ter sido alocado previamente.
 */
 void residuo(SistLinear_t *SL, real_t *X, real_t *R, int n)
 {
-  for(int i=0; i < n; ++i) {
-    R[i] = SL->b[i];
-    for(int j=0; j < n; ++j)
-      R[i] -= SL->A[i][j]*X[j];
+#pragma omp parallel if (n >= RES_PAR_MIN)
+  {
+    int modo = fegetround();
+    fesetround(FE_TONEAREST);
+
+#pragma omp for schedule(static, RES_BLOCO)
+    for(int i=0; i < n; ++i)
+      R[i] = residuoLinha(SL->A[i], X, SL->b[i], n);
+
+    fesetround(modo);
   }
 }
\ No newline at end of file
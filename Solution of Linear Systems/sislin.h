@@ -1,24 +1,74 @@
 #ifndef __SISLIN_H__
 #define __SISLIN_H__
 
+#include <stdint.h>
+
 // Parâmetros default para teste de convergência
 #define MAXIT 50
 #define TOL  1.0e-4
 
+// Resíduo e normas: linhas por bloco (unidade da soma compensada e da
+// divisão entre threads), acumuladores por linha e ordem mínima para
+// usar threads
+#define RES_BLOCO 64
+#define RES_VIAS 8
+#define RES_PAR_MIN 512
+
+#ifndef MIN
+#define MIN(a,b) ((a) < (b) ? (a) : (b))
+#endif
+
 // Estrutura para definiçao de um sistema linear qualquer
 typedef struct {
   unsigned int n; // tamanho do SL
-  real_t **A; // coeficientes
+  real_t **A; // coeficientes: A[i] aponta para uma linha de 'mem', mas a
+	      // ordem das linhas pode ser permutada (troca de ponteiros)
+  real_t *mem; // bloco contíguo com os n*n coeficientes
+  void *mapa; // se != NULL, 'mem' está neste mapeamento de arquivo
+  size_t tamMapa; // tamanho de 'mapa' em bytes
+  int *refs; // número de SLs que compartilham 'mem' (cópia na escrita)
+  unsigned int cap; // maior ordem que 'mem', 'A' e 'b' comportam
   real_t *b; // termos independentes
 } SistLinear_t;
 
+// Formato binário de SL: cabeçalho de 64 bytes seguido de A (n*n valores,
+// linha a linha) e b (n valores), sem separadores
+#define SL_MAGICO "SISLINB"
+#define SL_VERSAO 1
+#define SL_DTYPE_F64 1      // real_t = double IEEE-754
+#define SL_ORDEM 0x01020304 // lido diferente em máquina de outra endianness
+
+typedef struct {
+  char magico[8];        // SL_MAGICO
+  uint32_t versao;       // SL_VERSAO
+  uint32_t ordem;        // SL_ORDEM
+  uint64_t n;            // ordem do SL
+  uint32_t dtype;        // tipo dos valores: SL_DTYPE_F64
+  uint32_t flags;        // reservado: 0
+  char reservado[32];
+} CabecalhoSL_t;
+
 // Alocaçao e desalocação de matrizes
 SistLinear_t* alocaSisLin (unsigned int n);
 void liberaSisLin (SistLinear_t *SL);
 
+// Resultado da leitura de um SL da entrada por 'lerSisLinReusa()'
+typedef enum {
+  leituraOk = 0,     // SL lido
+  leituraFim,        // fim da entrada antes do próximo SL
+  leituraInvalida,   // token inválido ou SL incompleto
+  leituraSemMemoria  // erro de alocação
+} leitura_t;
+
 // Leitura e impressão de sistemas lineares
 SistLinear_t *lerSisLin ();
+SistLinear_t *lerSisLinReusa (SistLinear_t *SL, leitura_t *sit);
+SistLinear_t *lerSisLinScanf ();
+int salvaSisLinBin (SistLinear_t *SL, const char *arq);
+SistLinear_t *lerSisLinBin (const char *arq);
 SistLinear_t *dupSisLin (SistLinear_t *src);
+int materializaSisLin (SistLinear_t *SL);
+SistLinear_t *geraSisLin (unsigned int n, int diagDominante);
 void prnSisLin (SistLinear_t *SL);
 void prnVetor (real_t *vet, unsigned int n);
 
@@ -26,6 +76,7 @@ void prnVetor (real_t *vet, unsigned int n);
 real_t normaMax(real_t *X1, real_t *X0, int n);
 real_t normaL2(real_t *X, int n);
 void residuo(SistLinear_t *SL, real_t *X, real_t *R, int n);
+real_t residuoNormas(SistLinear_t *SL, real_t *X, real_t *R, int n, real_t *nMax);
 
 #endif // __SISLIN_H__
 
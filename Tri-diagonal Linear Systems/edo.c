@@ -9,6 +9,7 @@
 #include <stdio.h>
 #include <math.h>
 #include <stdlib.h>
+#include <omp.h>
 #include "utils.h"
 #include "edo.h"
 
@@ -16,10 +17,25 @@
 #define EPS 1.0e-5
 #define NORMA_STOP EPS
 
+void geraB_EDO (EDo *edo, real_t *B, int ld)
+{
+  real_t x, rx;
+  int n = edo->n;
+  real_t h = (edo->b - edo->a)/(n+1);
+
+  for (int i=0; i < n; ++i) {
+    x = edo->a + (i+1)*h;
+    rx = edo->r1*x + edo->r2*x*x + edo->r3*cos(x) + edo->r4*exp(x);
+    B[(long) i*ld] = h*h * rx;
+  }
+
+  B[0] -= edo->ya * (1 - h*edo->p/2.0);
+  B[(long) (n-1)*ld] -= edo->yb * (1 + h*edo->p/2.0);
+}
+
 Tridiag *genTridiag (EDo *edo)
 {
   Tridiag *sl;
-  real_t x, rx;
   int n = edo->n;
   
   sl = (Tridiag *) malloc (sizeof(Tridiag));
@@ -33,21 +49,27 @@ Tridiag *genTridiag (EDo *edo)
   real_t h = (edo->b - edo->a)/(n+1);
 
   for (int i=0; i < n; ++i) {
-    x = edo->a + (i+1)*h;
-    rx = edo->r1*x + edo->r2*x*x + edo->r3*cos(x) + edo->r4*exp(x);
-    
-    sl->B[i] = h*h * rx;
     sl->Di[i] = 1 - h * edo->p/2.0;
     sl->D[i] = -2 + h*h * edo->q;
     sl->Ds[i] = 1 + h * edo->p/2.0;
   }
 
-  sl->B[0] -= edo->ya * (1 - h*edo->p/2.0);
-  sl->B[n-1] -= edo->yb * (1 + h*edo->p/2.0);
+  geraB_EDO(edo, sl->B, 1);
   
   return sl;
 }
 
+void liberaTridiag (Tridiag *sl)
+{
+  if (sl) {
+    free(sl->D);
+    free(sl->Di);
+    free(sl->Ds);
+    free(sl->B);
+    free(sl);
+  }
+}
+
 int gaussSeidel_3Diag(Tridiag *sl, real_t *Y, int maxiter, real_t *norma) {
     const int n = sl->n;
     int it = 0;
@@ -69,6 +91,334 @@ int gaussSeidel_3Diag(Tridiag *sl, real_t *Y, int maxiter, real_t *norma) {
     return it;
 }
 
+// Dominância da linha 'i': -1 se |D[i]| < soma dos módulos fora da
+// diagonal, 0 se igual, 1 se maior
+static inline int dominanciaLinha(Tridiag *sl, int i) {
+    real_t fora = 0.0;
+    if (i > 0)
+        fora += ABS(sl->Di[i - 1]);
+    if (i < sl->n - 1)
+        fora += ABS(sl->Ds[i]);
+
+    return (ABS(sl->D[i]) < fora) ? -1 : (ABS(sl->D[i]) > fora);
+}
+
+int diagDominante_3Diag(Tridiag *sl) {
+    const int n = sl->n;
+    int estrita = 0;
+
+    for (int i = 0; i < n; ++i) {
+        int dom = dominanciaLinha(sl, i);
+        if (dom < 0)
+            return 0;
+        if (dom > 0)
+            estrita = 1;
+    }
+
+    return estrita;
+}
+
+int thomas_3Diag(Tridiag *sl, real_t *Y) {
+    const int n = sl->n;
+    real_t *c = (real_t *) malloc(n * sizeof(real_t));
+    real_t m;
+
+    if (!c)
+        return -1;
+
+    // Eliminação: c[i] = Ds[i]/m e Y[i] = (B[i] - Di[i-1]*Y[i-1])/m, com
+    // m = D[i] - Di[i-1]*c[i-1] o pivô da linha i
+    m = sl->D[0];
+    if (m == 0.0) {
+        free(c);
+        return -1;
+    }
+    c[0] = sl->Ds[0] / m;
+    Y[0] = sl->B[0] / m;
+
+    for (int i = 1; i < n; ++i) {
+        m = sl->D[i] - sl->Di[i - 1] * c[i - 1];
+        if (m == 0.0) {
+            free(c);
+            return -1;
+        }
+        c[i] = sl->Ds[i] / m;
+        Y[i] = (sl->B[i] - sl->Di[i - 1] * Y[i - 1]) / m;
+    }
+
+    // Retrossubstituição
+    for (int i = n - 2; i >= 0; --i)
+        Y[i] -= c[i] * Y[i + 1];
+
+    free(c);
+
+    return diagDominante_3Diag(sl) ? 0 : 1;
+}
+
+/* Linha inicial do bloco 'k' de 'nb' blocos de tamanhos iguais (a menos
+   de 1) das 'n' linhas */
+#define INI_BLOCO(k, nb, n) ((int) (((long long) (k) * (n)) / (nb)))
+
+int thomasPar_3Diag(Tridiag *sl, real_t *Y, int nBlocos) {
+    const int n = sl->n;
+    const real_t *Di = sl->Di, *D = sl->D, *Ds = sl->Ds, *B = sl->B;
+
+    if (nBlocos <= 0)
+        nBlocos = omp_get_max_threads();
+    if (nBlocos > n / BLOCO_MIN_3DIAG)
+        nBlocos = n / BLOCO_MIN_3DIAG;
+    if (nBlocos < 2)
+        return thomas_3Diag(sl, Y);
+
+    const int P = nBlocos;
+    real_t *c = (real_t *) malloc(n * sizeof(real_t));
+    real_t *v = (real_t *) malloc(n * sizeof(real_t));
+    // Por bloco: w na primeira linha interna; sistema reduzido (P-1)
+    real_t *wIni = (real_t *) malloc(P * sizeof(real_t));
+    real_t *rd = (real_t *) malloc(4 * P * sizeof(real_t));
+    int falhou = 0, dominante = 1, estrita = 0;
+
+    if (!c || !v || !wIni || !rd) {
+        free(c);
+        free(v);
+        free(wIni);
+        free(rd);
+        return -1;
+    }
+
+    // 1. Cada bloco: Thomas nas linhas internas [s, e), com 3 lados
+    //    direitos: B (em Y), o acoplamento com o separador à esquerda
+    //    (Di[s-1] na linha s, em v) e à direita (Ds[e-1] na linha e-1, w).
+    //    Depois, x[i] = Y[i] - v[i]*x[s-1] - w[i]*x[e]. w[e-1] = c[e-1] e
+    //    w[i] = -c[i]*w[i+1], então w não precisa ser guardado.
+#pragma omp parallel for schedule(static) reduction(||: falhou) reduction(&&: dominante) reduction(||: estrita)
+    for (int k = 0; k < P; ++k) {
+        int s = INI_BLOCO(k, P, n);
+        int e = (k < P - 1) ? INI_BLOCO(k + 1, P, n) - 1 : n;
+        real_t m = D[s];
+
+        if (m == 0.0) {
+            falhou = 1;
+            continue;
+        }
+        c[s] = Ds[s] / m;
+        Y[s] = B[s] / m;
+        v[s] = (k > 0) ? Di[s - 1] / m : 0.0;
+
+        for (int i = s + 1; i < e; ++i) {
+            m = D[i] - Di[i - 1] * c[i - 1];
+            if (m == 0.0)
+                falhou = 1;
+            c[i] = Ds[i] / m;
+            Y[i] = (B[i] - Di[i - 1] * Y[i - 1]) / m;
+            v[i] = -Di[i - 1] * v[i - 1] / m;
+        }
+
+        real_t w = c[e - 1];
+        for (int i = e - 2; i >= s; --i) {
+            Y[i] -= c[i] * Y[i + 1];
+            v[i] -= c[i] * v[i + 1];
+            w *= -c[i];
+        }
+        wIni[k] = (k < P - 1) ? w : 0.0;
+
+        // Linha 'e' é o separador do bloco (exceto no último)
+        for (int i = s; i <= e && i < n; ++i) {
+            int dom = dominanciaLinha(sl, i);
+            if (dom < 0)
+                dominante = 0;
+            else if (dom > 0)
+                estrita = 1;
+        }
+    }
+
+    if (falhou) {
+        free(c);
+        free(v);
+        free(wIni);
+        free(rd);
+        return -1;
+    }
+
+    // 2. Sistema tridiagonal reduzido nos P-1 separadores q[k] = x[r],
+    //    r = última linha do bloco k, substituindo x[r-1] e x[r+1] na
+    //    equação da linha r. Resolvido com Thomas (serial, ordem pequena).
+    real_t *ri = rd, *rdg = rd + P, *rs = rd + 2 * P, *q = rd + 3 * P;
+
+    for (int k = 0; k < P - 1; ++k) {
+        int r = INI_BLOCO(k + 1, P, n) - 1;
+        ri[k] = -Di[r - 1] * v[r - 1];
+        rdg[k] = D[r] - Di[r - 1] * c[r - 1] - Ds[r] * v[r + 1];
+        rs[k] = -Ds[r] * wIni[k + 1];
+        q[k] = B[r] - Di[r - 1] * Y[r - 1] - Ds[r] * Y[r + 1];
+    }
+
+    for (int k = 1; k < P - 1; ++k) {
+        real_t f = ri[k] / rdg[k - 1];
+        rdg[k] -= f * rs[k - 1];
+        q[k] -= f * q[k - 1];
+    }
+    q[P - 2] /= rdg[P - 2];
+    for (int k = P - 3; k >= 0; --k)
+        q[k] = (q[k] - rs[k] * q[k + 1]) / rdg[k];
+
+    // 3. Cada bloco recupera suas linhas internas a partir dos separadores
+#pragma omp parallel for schedule(static)
+    for (int k = 0; k < P; ++k) {
+        int s = INI_BLOCO(k, P, n);
+        int e = (k < P - 1) ? INI_BLOCO(k + 1, P, n) - 1 : n;
+        real_t xl = (k > 0) ? q[k - 1] : 0.0;
+        real_t xr = (k < P - 1) ? q[k] : 0.0;
+        real_t w = (k < P - 1) ? c[e - 1] : 0.0;
+
+        for (int i = e - 1; i >= s; --i) {
+            Y[i] -= v[i] * xl + w * xr;
+            if (i > s)
+                w *= -c[i - 1];
+        }
+        if (k < P - 1)
+            Y[e] = xr;
+    }
+
+    free(c);
+    free(v);
+    free(wIni);
+    free(rd);
+
+    return (dominante && estrita) ? 0 : 1;
+}
+
+int thomasMult_3Diag(Tridiag *sl, real_t *B, real_t *Y, int m) {
+    const int n = sl->n;
+    real_t *c = (real_t *) malloc(n * sizeof(real_t));
+    real_t piv;
+
+    if (!c)
+        return -1;
+
+    // Mesmas operações de thomas_3Diag, com o pivô e c[i] de cada linha
+    // calculados uma vez e aplicados às 'm' colunas (contíguas na linha)
+    piv = sl->D[0];
+    if (piv == 0.0) {
+        free(c);
+        return -1;
+    }
+    c[0] = sl->Ds[0] / piv;
+    for (int r = 0; r < m; ++r)
+        Y[r] = B[r] / piv;
+
+    for (int i = 1; i < n; ++i) {
+        real_t *y = Y + (long) i * m, *yAnt = y - m, *b = B + (long) i * m;
+        real_t di = sl->Di[i - 1];
+
+        piv = sl->D[i] - di * c[i - 1];
+        if (piv == 0.0) {
+            free(c);
+            return -1;
+        }
+        c[i] = sl->Ds[i] / piv;
+        for (int r = 0; r < m; ++r)
+            y[r] = (b[r] - di * yAnt[r]) / piv;
+    }
+
+    for (int i = n - 2; i >= 0; --i) {
+        real_t *y = Y + (long) i * m, *yProx = y + m;
+        for (int r = 0; r < m; ++r)
+            y[r] -= c[i] * yProx[r];
+    }
+
+    free(c);
+
+    return diagDominante_3Diag(sl) ? 0 : 1;
+}
+
+int gaussSeidelMult_3Diag(Tridiag *sl, real_t *B, real_t *Y, int m, int maxiter,
+                          real_t *norma, int *iter) {
+    const int n = sl->n;
+    const real_t *D = sl->D, *Di = sl->Di, *Ds = sl->Ds;
+    int *ativas = (int *) malloc(m * sizeof(int));
+    real_t *soma = (real_t *) malloc(m * sizeof(real_t));
+    int nAtivas = m, it = 0;
+
+    if (!ativas || !soma) {
+        free(ativas);
+        free(soma);
+        return -1;
+    }
+
+    for (int r = 0; r < m; ++r)
+        ativas[r] = r;
+
+    // Cada varredura percorre as linhas uma vez, atualizando todas as
+    // colunas ativas; por coluna, as operações e sua ordem são as de
+    // gaussSeidel_3Diag e normaL2_3Diag
+    while (nAtivas > 0 && it < maxiter) {
+        for (int a = 0; a < nAtivas; ++a) {
+            int r = ativas[a];
+            Y[r] = (B[r] - Ds[0] * Y[m + r]) / D[0];
+        }
+        for (int i = 1; i < n - 1; ++i) {
+            real_t *y = Y + (long) i * m, *b = B + (long) i * m;
+            real_t *yAnt = y - m, *yProx = y + m;
+            real_t di = Di[i - 1], d = D[i], ds = Ds[i];
+            for (int a = 0; a < nAtivas; ++a) {
+                int r = ativas[a];
+                y[r] = (b[r] - di * yAnt[r] - ds * yProx[r]) / d;
+            }
+        }
+        {
+            real_t *y = Y + (long) (n - 1) * m, *b = B + (long) (n - 1) * m;
+            for (int a = 0; a < nAtivas; ++a) {
+                int r = ativas[a];
+                y[r] = (b[r] - Di[n - 2] * y[r - m]) / D[n - 1];
+            }
+        }
+
+        // Norma L2 do resíduo de cada coluna ativa
+        for (int a = 0; a < nAtivas; ++a) {
+            int r = ativas[a];
+            real_t res = B[r] - (D[0] * Y[r] + Ds[0] * Y[m + r]);
+            soma[r] = res * res;
+        }
+        for (int i = 1; i < n - 1; ++i) {
+            real_t *y = Y + (long) i * m, *b = B + (long) i * m;
+            real_t *yAnt = y - m, *yProx = y + m;
+            real_t di = Di[i - 1], d = D[i], ds = Ds[i];
+            for (int a = 0; a < nAtivas; ++a) {
+                int r = ativas[a];
+                real_t res = b[r] - (di * yAnt[r] + d * y[r] + ds * yProx[r]);
+                soma[r] += res * res;
+            }
+        }
+        {
+            real_t *y = Y + (long) (n - 1) * m, *b = B + (long) (n - 1) * m;
+            for (int a = 0; a < nAtivas; ++a) {
+                int r = ativas[a];
+                real_t res = b[r] - (Di[n-2] * y[r - m] + D[n-1] * y[r]);
+                soma[r] += res * res;
+            }
+        }
+
+        it++;
+
+        // Colunas convergidas saem das próximas varreduras
+        int nova = 0;
+        for (int a = 0; a < nAtivas; ++a) {
+            int r = ativas[a];
+            norma[r] = sqrt(soma[r]);
+            iter[r] = it;
+            if (norma[r] > NORMA_STOP)
+                ativas[nova++] = r;
+        }
+        nAtivas = nova;
+    }
+
+    free(ativas);
+    free(soma);
+
+    return it;
+}
+
 real_t normaL2_3Diag (Tridiag *sl, real_t *Y) {
     int n = sl->n;
     real_t normaL2 = 0.0;
@@ -71,6 +71,26 @@ typedef struct {
  */
 Tridiag *genTridiag (EDo *edoeq);
 
+/**
+ * @brief Gera os termos independentes do sistema de 'edo'
+ * 
+ * Mesmo cálculo de genTridiag para o vetor B, que é o único que depende
+ * de r(x). Permite gerar as diagonais uma vez e os termos independentes
+ * de várias EDOs com os mesmos n, a, b, ya, yb, p e q.
+ * 
+ * @param edo Ponteiro para a estrutura EDO
+ * @param B Vetor de saída; o elemento i é gravado em B[i*ld]
+ * @param ld Distância entre elementos consecutivos em B (1: vetor
+ *        contíguo; m: coluna de uma matriz n x m por linhas)
+ */
+void geraB_EDO (EDo *edo, real_t *B, int ld);
+
+/**
+ * @brief Libera um sistema tridiagonal gerado por genTridiag
+ * @param sl Ponteiro para o sistema tridiagonal (pode ser NULL)
+ */
+void liberaTridiag (Tridiag *sl);
+
 /**
  * @brief Resolve sistema tridiagonal usando método de Gauss-Seidel (versão otimizada)
  * 
@@ -85,6 +105,98 @@ Tridiag *genTridiag (EDo *edoeq);
  */
 int gaussSeidel_3Diag(Tridiag *sl, real_t *Y, int maxiter, real_t *norma);
 
+/**
+ * @brief Resolve sistema tridiagonal pelo algoritmo de Thomas (método direto)
+ * 
+ * Eliminação de Gauss sem pivoteamento especializada para a estrutura
+ * tridiagonal: uma passada de eliminação e uma de retrossubstituição, em
+ * O(n), sem iterações. O sistema 'sl' não é alterado (usa vetor auxiliar
+ * de tamanho n).
+ * 
+ * Sem pivoteamento, a estabilidade só é garantida se a matriz é
+ * diagonalmente dominante; caso contrário a solução é calculada, mas o
+ * retorno avisa.
+ * 
+ * @param sl Ponteiro para o sistema tridiagonal
+ * @param Y Vetor solução (saída)
+ * @return 0 se resolvido, 1 se resolvido mas a matriz não é diagonalmente
+ *         dominante, -1 se pivô nulo ou erro de alocação
+ */
+int thomas_3Diag(Tridiag *sl, real_t *Y);
+
+// Menor número de linhas por bloco de thomasPar_3Diag
+#define BLOCO_MIN_3DIAG 4096
+
+/**
+ * @brief Resolve sistema tridiagonal em paralelo pelo método de partição
+ * 
+ * As linhas são divididas em 'nBlocos' blocos; a última linha de cada
+ * bloco (menos o último) é um separador. Em paralelo, cada bloco resolve
+ * suas linhas internas por Thomas com três lados direitos (B e os
+ * acoplamentos com os separadores vizinhos). Os separadores formam um
+ * sistema tridiagonal de ordem nBlocos-1, resolvido em série; então cada
+ * bloco, em paralelo, recupera suas linhas internas. Cerca de 2,5 vezes
+ * as operações de thomas_3Diag, divididas entre as threads. Usa 2 vetores
+ * auxiliares de tamanho n.
+ * 
+ * @param sl Ponteiro para o sistema tridiagonal (não é alterado)
+ * @param Y Vetor solução (saída)
+ * @param nBlocos Número de blocos; se <= 0, o número de threads OpenMP.
+ *        Limitado a n/BLOCO_MIN_3DIAG; com menos de 2 blocos, usa
+ *        thomas_3Diag
+ * @return como thomas_3Diag
+ */
+int thomasPar_3Diag(Tridiag *sl, real_t *Y, int nBlocos);
+
+/**
+ * @brief Verifica se a matriz tridiagonal é diagonalmente dominante
+ * 
+ * |D[i]| >= |Di[i-1]| + |Ds[i]| em todas as linhas, com desigualdade
+ * estrita em pelo menos uma (suficiente para o algoritmo de Thomas sem
+ * pivoteamento, em matriz irredutível).
+ * 
+ * @param sl Ponteiro para o sistema tridiagonal
+ * @return 1 se diagonalmente dominante, 0 caso contrário
+ */
+int diagDominante_3Diag(Tridiag *sl);
+
+/**
+ * @brief Resolve 'm' sistemas com a mesma matriz tridiagonal de 'sl' pelo
+ * algoritmo de Thomas, com uma única fatoração
+ * 
+ * Os pivôs e coeficientes da eliminação são calculados uma vez por linha e
+ * aplicados a todos os lados direitos. Cada coluna tem o mesmo resultado
+ * de thomas_3Diag com aquele lado direito. 'sl->B' não é usado.
+ * 
+ * @param sl Ponteiro para o sistema tridiagonal (apenas as diagonais)
+ * @param B Lados direitos, matriz n x m por linhas: B[i*m + r]
+ * @param Y Soluções, no mesmo formato de B (saída)
+ * @param m Número de lados direitos
+ * @return como thomas_3Diag
+ */
+int thomasMult_3Diag(Tridiag *sl, real_t *B, real_t *Y, int m);
+
+/**
+ * @brief Gauss-Seidel em 'm' sistemas com a mesma matriz tridiagonal de
+ * 'sl', em varreduras conjuntas
+ * 
+ * Cada varredura atualiza todas as colunas ainda não convergidas, linha a
+ * linha; uma coluna deixa de ser atualizada quando a norma L2 do seu
+ * resíduo atinge NORMA_STOP. Cada coluna tem o mesmo resultado de
+ * gaussSeidel_3Diag com aquele lado direito. 'sl->B' não é usado.
+ * 
+ * @param sl Ponteiro para o sistema tridiagonal (apenas as diagonais)
+ * @param B Lados direitos, matriz n x m por linhas: B[i*m + r]
+ * @param Y Soluções (entrada: chutes iniciais, saída: soluções), como B
+ * @param m Número de lados direitos
+ * @param maxiter Número máximo de varreduras
+ * @param norma Norma L2 do resíduo final de cada coluna (saída, tamanho m)
+ * @param iter Iterações de cada coluna (saída, tamanho m)
+ * @return Número de varreduras realizadas, ou -1 se erro de alocação
+ */
+int gaussSeidelMult_3Diag(Tridiag *sl, real_t *B, real_t *Y, int m, int maxiter,
+                          real_t *norma, int *iter);
+
 /**
  * @brief Calcula a norma L2 do resíduo para sistemas tridiagonais
  * 
@@ -7,8 +7,9 @@
  * Resolve EDOs da forma: y'' + py' + qy = r(x)
  * onde r(x) = r1*x + r2*x² + r3*cos(x) + r4*exp(x)
  * 
- * Usa discretização por diferenças finitas e método iterativo de Gauss-Seidel
- * para resolver o sistema linear tridiagonal resultante.
+ * Usa discretização por diferenças finitas e resolve o sistema linear
+ * tridiagonal resultante pelo método iterativo de Gauss-Seidel ou pelo
+ * algoritmo direto de Thomas.
  */
 
 #include <stdio.h>
@@ -16,15 +17,303 @@
 #include <math.h>
 #include <float.h>
 #include <fenv.h>
+#include <getopt.h>
+#include <omp.h>
 #include <likwid.h>
 #include "utils.h"
 #include "edo.h"
 
 #define MAXIT 100
 
+// Execuções de cada medida de 'escalabilidade()' (vale a menor)
+#define REP_ESCALA 3
+
+/**
+ * @brief Exibe mensagem de erro indicando forma de uso do programa e
+ * termina o programa
+ */
+static void usage(char *progname)
+{
+  fprintf(stderr, "Forma de uso: %s [ -t | -c | -e <threads> ] [ -m ] [ -n <n> ] < edos.dat\n", progname);
+  fprintf(stderr, "  -t: resolve com o algoritmo de Thomas em vez de Gauss-Seidel\n");
+  fprintf(stderr, "  -c: compara Gauss-Seidel e Thomas (tempos, sem imprimir o SL)\n");
+  fprintf(stderr, "  -e <threads>: escalabilidade do Thomas paralelo com 1, 2, 4, ... threads\n");
+  fprintf(stderr, "  -m: resolve todas as EDOs em lote (mesma matriz) e compara com o laço por EDO\n");
+  fprintf(stderr, "  -n <n>: usa malha de 'n' pontos em vez do 'n' da entrada\n");
+  exit(1);
+}
+
+/**
+ * @brief Maior diferença absoluta entre dois vetores
+ */
+static real_t difMax(real_t *X1, real_t *X0, int n)
+{
+  real_t k, dif = 0.0;
+
+  for (int i = 0; i < n; ++i)
+    if ((k = ABS(X1[i] - X0[i])) > dif)
+      dif = k;
+
+  return dif;
+}
+
+/**
+ * @brief Resolve 'sl' com Thomas, avisando em stderr se o SL não é
+ * diagonalmente dominante ou se há pivô nulo
+ * @return retorno de thomas_3Diag
+ */
+static int resolveThomas(Tridiag *sl, real_t *Y, int edo_count)
+{
+  string_t marker_name = markerName("Thomas", edo_count);
+
+  LIKWID_MARKER_START(marker_name);
+  int ret = thomas_3Diag(sl, Y);
+  LIKWID_MARKER_STOP(marker_name);
+  free(marker_name);
+
+  if (ret < 0)
+    fprintf(stderr, "EDO %d: pivô nulo ou falha de alocação no algoritmo de Thomas\n", edo_count);
+  else if (ret)
+    fprintf(stderr, "AVISO: EDO %d: matriz não é diagonalmente dominante; "
+            "Thomas (sem pivoteamento) pode ser instável\n", edo_count);
+
+  return ret;
+}
+
+/**
+ * @brief Resolve 'sl' com Gauss-Seidel (chute inicial nulo) e com Thomas e
+ * imprime lado a lado iterações, norma L2 do resíduo e tempo de cada um
+ */
+static void comparaMetodos(Tridiag *sl, int edo_count)
+{
+  int n = sl->n;
+  real_t *y_gs = (real_t *) calloc(n, sizeof(real_t));
+  real_t *y_th = (real_t *) malloc(n * sizeof(real_t));
+  real_t norma_gs, tempo_gs, tempo_th;
+
+  if (!y_gs || !y_th) {
+    fprintf(stderr, "Erro de alocação de memória.\n");
+    exit(-1);
+  }
+
+  string_t marker_name = markerName("Gauss-Seidel", edo_count);
+  tempo_gs = timestamp();
+  LIKWID_MARKER_START(marker_name);
+  int iter = gaussSeidel_3Diag(sl, y_gs, MAXIT, &norma_gs);
+  LIKWID_MARKER_STOP(marker_name);
+  tempo_gs = timestamp() - tempo_gs;
+  free(marker_name);
+
+  tempo_th = timestamp();
+  int ret = resolveThomas(sl, y_th, edo_count);
+  tempo_th = timestamp() - tempo_th;
+
+  real_t *y_par = (real_t *) malloc(n * sizeof(real_t));
+  rtime_t tempo_par = timestamp();
+  int ret_par = y_par ? thomasPar_3Diag(sl, y_par, 0) : -1;
+  tempo_par = timestamp() - tempo_par;
+
+  printf("EDO %d [ n = %d ]:\n", edo_count, n);
+  printf("  Gauss-Seidel: %4d iterações, norma L2 = " FORMAT ", %.8e ms\n",
+         iter, norma_gs, tempo_gs);
+  if (ret >= 0) {
+    printf("  Thomas:          1 passada,  norma L2 = " FORMAT ", %.8e ms\n",
+           normaL2_3Diag(sl, y_th), tempo_th);
+    if (ret_par >= 0)
+      printf("  Thomas paralelo (%d threads): norma L2 = " FORMAT ", %.8e ms\n",
+             omp_get_max_threads(), normaL2_3Diag(sl, y_par), tempo_par);
+    printf("  Thomas %.2f vezes mais rápido, dif. máx. entre soluções = %g\n\n",
+           tempo_gs / tempo_th, difMax(y_gs, y_th, n));
+  }
+  else
+    printf("  Thomas: falhou\n\n");
+
+  free(y_gs);
+  free(y_th);
+  free(y_par);
+}
+
+/**
+ * @brief Escalabilidade de thomasPar_3Diag: resolve 'sl' com thomas_3Diag
+ * (referência sequencial) e com thomasPar_3Diag com 1, 2, 4, ...,
+ * 'maxThreads' threads (um bloco por thread), e imprime em CSV, para cada
+ * número de threads, o melhor tempo de REP_ESCALA execuções, o speedup e a
+ * eficiência em relação à referência e a diferença máxima entre soluções
+ */
+static void escalabilidade(Tridiag *sl, int maxThreads, int edo_count)
+{
+  int n = sl->n;
+  real_t *y_seq = (real_t *) malloc(n * sizeof(real_t));
+  real_t *y_par = (real_t *) malloc(n * sizeof(real_t));
+  rtime_t tempo_seq = 0.0;
+  int threadsAnt = omp_get_max_threads();
+
+  if (!y_seq || !y_par) {
+    fprintf(stderr, "Erro de alocação de memória.\n");
+    exit(-1);
+  }
+
+  for (int r = 0; r < REP_ESCALA; ++r) {
+    rtime_t t = timestamp();
+    thomas_3Diag(sl, y_seq);
+    t = timestamp() - t;
+    if (!r || t < tempo_seq)
+      tempo_seq = t;
+  }
+
+  printf("edo,n,threads,tempo_ms,speedup,eficiencia,dif_max\n");
+  printf("%d,%d,seq,%.8e,1,1,0\n", edo_count, n, tempo_seq);
+
+  for (int t = 1; t <= maxThreads; t = (2*t <= maxThreads || t == maxThreads) ? 2*t : maxThreads) {
+    rtime_t tempo = 0.0;
+
+    omp_set_num_threads(t);
+    string_t marker_name = markerName("Thomas-Paralelo", t);
+    for (int r = 0; r < REP_ESCALA; ++r) {
+      rtime_t tr = timestamp();
+      LIKWID_MARKER_START(marker_name);
+      thomasPar_3Diag(sl, y_par, t);
+      LIKWID_MARKER_STOP(marker_name);
+      tr = timestamp() - tr;
+      if (!r || tr < tempo)
+        tempo = tr;
+    }
+    free(marker_name);
+
+    printf("%d,%d,%d,%.8e,%.4f,%.4f,%g\n", edo_count, n, t, tempo,
+           tempo_seq / tempo, tempo_seq / (tempo * t), difMax(y_seq, y_par, n));
+  }
+
+  omp_set_num_threads(threadsAnt);
+
+  free(y_seq);
+  free(y_par);
+}
+
+/**
+ * @brief Resolve as 'm' EDOs de 'edos' (mesmos n, a, b, ya, yb, p e q;
+ * r(x) diferente) de duas formas e compara os tempos:
+ * - laço por EDO, como o modo padrão (sem impressão): genTridiag e
+ *   solução para cada EDO;
+ * - em lote: diagonais geradas uma vez, lados direitos de todas as EDOs
+ *   em uma matriz n x m ('geraB_EDO()') e solução conjunta, com uma
+ *   fatoração (Thomas, com 'thomas') ou varreduras conjuntas de
+ *   Gauss-Seidel.
+ * Imprime, por EDO, iterações, norma L2 do resíduo e diferença máxima
+ * entre as duas soluções, e o speedup do lote.
+ */
+static void resolveLote(EDo *edos, int m, int thomas)
+{
+  int n = edos[0].n;
+  real_t *yRef = (real_t *) malloc((long) n * m * sizeof(real_t));
+  real_t *normaRef = (real_t *) malloc(m * sizeof(real_t));
+  real_t *norma = (real_t *) malloc(m * sizeof(real_t));
+  int *iterRef = (int *) malloc(m * sizeof(int));
+  int *iter = (int *) malloc(m * sizeof(int));
+  real_t *col = (real_t *) malloc(n * sizeof(real_t));
+  rtime_t tempo_loop = 0.0, tempo_lote;
+
+  if (!yRef || !normaRef || !norma || !iterRef || !iter || !col) {
+    fprintf(stderr, "Erro de alocação de memória.\n");
+    exit(-1);
+  }
+
+  // Laço por EDO (referência)
+  for (int r = 0; r < m; ++r) {
+    rtime_t tempo = timestamp();
+    LIKWID_MARKER_START("Laco-EDO");
+    Tridiag *sl = genTridiag(&edos[r]);
+    real_t *sol = (real_t *) calloc(n, sizeof(real_t));
+    if (thomas) {
+      thomas_3Diag(sl, sol);
+      iterRef[r] = 1;
+    }
+    else
+      iterRef[r] = gaussSeidel_3Diag(sl, sol, MAXIT, &normaRef[r]);
+    LIKWID_MARKER_STOP("Laco-EDO");
+    tempo_loop += timestamp() - tempo;
+
+    if (thomas)
+      normaRef[r] = normaL2_3Diag(sl, sol);
+    for (int i = 0; i < n; ++i)
+      yRef[(long) i * m + r] = sol[i];
+
+    liberaTridiag(sl);
+    free(sol);
+  }
+
+  // Em lote
+  tempo_lote = timestamp();
+  LIKWID_MARKER_START("Lote-EDO");
+  Tridiag *sl = genTridiag(&edos[0]);
+  real_t *B = (real_t *) malloc((long) n * m * sizeof(real_t));
+  real_t *Y = (real_t *) calloc((long) n * m, sizeof(real_t));
+  if (!B || !Y) {
+    fprintf(stderr, "Erro de alocação de memória.\n");
+    exit(-1);
+  }
+  for (int r = 0; r < m; ++r)
+    geraB_EDO(&edos[r], B + r, m);
+
+  int ret;
+  if (thomas) {
+    ret = thomasMult_3Diag(sl, B, Y, m);
+    for (int r = 0; r < m; ++r)
+      iter[r] = 1;
+  }
+  else
+    ret = gaussSeidelMult_3Diag(sl, B, Y, m, MAXIT, norma, iter);
+  LIKWID_MARKER_STOP("Lote-EDO");
+  tempo_lote = timestamp() - tempo_lote;
+
+  if (ret < 0) {
+    fprintf(stderr, "Falha na solução em lote.\n");
+    exit(-1);
+  }
+
+  for (int r = 0; r < m; ++r) {
+    real_t dif = 0.0;
+
+    if (thomas) {
+      // normaL2_3Diag usa sl->B e um vetor contíguo: copia a coluna r
+      for (int i = 0; i < n; ++i) {
+        sl->B[i] = B[(long) i * m + r];
+        col[i] = Y[(long) i * m + r];
+      }
+      norma[r] = normaL2_3Diag(sl, col);
+    }
+
+    for (int i = 0; i < n; ++i)
+      yRef[(long) i * m + r] -= Y[(long) i * m + r];
+
+    for (int i = 0; i < n; ++i)
+      if (ABS(yRef[(long) i * m + r]) > dif)
+        dif = ABS(yRef[(long) i * m + r]);
+
+    printf("EDO %d: %d iterações (%d no laço), norma L2 = " FORMAT
+           ", dif. máx. para o laço = %g\n", r + 1, iter[r], iterRef[r], norma[r], dif);
+  }
+
+  printf("%s, %d EDOs, n = %d:\n", thomas ? "Thomas" : "Gauss-Seidel", m, n);
+  printf("  laço por EDO: %.8e ms\n", tempo_loop);
+  printf("  em lote:      %.8e ms (%.2f vezes mais rápido)\n", tempo_lote, tempo_loop / tempo_lote);
+
+  liberaTridiag(sl);
+  free(B);
+  free(Y);
+  free(yRef);
+  free(normaRef);
+  free(norma);
+  free(iterRef);
+  free(iter);
+  free(col);
+}
+
 /**
  * @brief Função principal do programa
  * 
+ * Forma de uso: resolveEDO [ -t | -c | -e <threads> ] [ -m ] [ -n <n> ] < edos.dat
+ * 
  * Lê dados da entrada padrão no formato:
  * - Linha 1: número de pontos da malha (n)
  * - Linha 2: intervalo [a, b]
@@ -34,13 +323,50 @@
  * 
  * Para cada EDO:
  * 1. Gera e imprime o sistema linear tridiagonal
- * 2. Resolve usando Gauss-Seidel
+ * 2. Resolve usando Gauss-Seidel, ou Thomas com '-t' (1 iteração)
  * 3. Imprime solução e estatísticas (iterações, resíduo, tempo)
  * 
+ * Com '-c', para cada EDO resolve com os dois métodos e imprime apenas a
+ * comparação ('comparaMetodos()'), viável para malhas grandes (-n até 10⁷).
+ * Com '-e', mede a escalabilidade do Thomas paralelo ('escalabilidade()').
+ * Com '-m', lê todas as EDOs e as resolve em lote, com as diagonais
+ * geradas uma vez ('resolveLote()'); com '-t -m', em lote por Thomas.
+ * 
  * @return 0 se execução bem-sucedida
  */
-int main ()
+int main (int argc, char *argv[])
 {
+  int thomas = 0, comparar = 0, nMalha = 0, maxThreads = 0, lote = 0, opt;
+
+  while ((opt = getopt(argc, argv, "tce:mn:")) != -1) {
+    switch (opt) {
+    case 't':
+      thomas = 1;
+      break;
+    case 'c':
+      comparar = 1;
+      break;
+    case 'm':
+      lote = 1;
+      break;
+    case 'e':
+      maxThreads = atoi(optarg);
+      if (maxThreads < 1)
+        usage(argv[0]);
+      break;
+    case 'n':
+      nMalha = atoi(optarg);
+      if (nMalha < 2)
+        usage(argv[0]);
+      break;
+    default:
+      usage(argv[0]);
+    }
+  }
+
+  if (thomas + comparar + (maxThreads > 0) > 1 || (lote && (comparar || maxThreads)))
+    usage(argv[0]);
+
   LIKWID_MARKER_INIT;
 
   // Configura arredondamento para baixo conforme especificação
@@ -59,14 +385,53 @@ int main ()
   scanf("%lf %lf", &edo.ya, &edo.yb);
   scanf("%lf %lf", &edo.p, &edo.q);
 
+  if (nMalha)
+    edo.n = nMalha;
+
+  if (lote) {
+    EDo *edos = NULL;
+    int m = 0, cap = 0;
+
+    while (scanf("%lf %lf %lf %lf", &edo.r1, &edo.r2, &edo.r3, &edo.r4) == 4) {
+      if (m == cap) {
+        cap = cap ? 2 * cap : 16;
+        edos = (EDo *) realloc(edos, cap * sizeof(EDo));
+        if (!edos) {
+          fprintf(stderr, "Erro de alocação de memória.\n");
+          exit(-1);
+        }
+      }
+      edos[m++] = edo;
+    }
+
+    if (m)
+      resolveLote(edos, m, thomas);
+    free(edos);
+
+    fesetround(FE_TONEAREST);
+    LIKWID_MARKER_CLOSE;
+    return 0;
+  }
+
   // Loop para processar múltiplas EDOs (diferentes r(x))
   while (scanf("%lf %lf %lf %lf", &edo.r1, &edo.r2, &edo.r3, &edo.r4) == 4) {
     edo_count++;
-    string_t marker_name = markerName("Gauss-Seidel", edo_count);
     
     // Gera o sistema linear tridiagonal correspondente à EDO
     sl = genTridiag(&edo);
 
+    if (maxThreads) {
+      escalabilidade(sl, maxThreads, edo_count);
+      liberaTridiag(sl);
+      continue;
+    }
+
+    if (comparar) {
+      comparaMetodos(sl, edo_count);
+      liberaTridiag(sl);
+      continue;
+    }
+
     // Imprime a ordem e matriz aumentada do sistema
     prnEDOsl(&edo);
 
@@ -78,12 +443,23 @@ int main ()
         sol[i] = 0.0;
     }
 
-    // Resolve o sistema usando Gauss-Seidel e mede o tempo
-    tempo = timestamp();
-    LIKWID_MARKER_START(marker_name);
-    iter = gaussSeidel_3Diag(sl, sol, 100, &norma_residuo);
-    LIKWID_MARKER_STOP(marker_name);
-    tempo = timestamp() - tempo;
+    // Resolve o sistema e mede o tempo
+    if (thomas) {
+      tempo = timestamp();
+      resolveThomas(sl, sol, edo_count);
+      tempo = timestamp() - tempo;
+      iter = 1;
+      norma_residuo = normaL2_3Diag(sl, sol);
+    }
+    else {
+      string_t marker_name = markerName("Gauss-Seidel", edo_count);
+      tempo = timestamp();
+      LIKWID_MARKER_START(marker_name);
+      iter = gaussSeidel_3Diag(sl, sol, MAXIT, &norma_residuo);
+      LIKWID_MARKER_STOP(marker_name);
+      tempo = timestamp() - tempo;
+      free(marker_name);  // Libera string do nome do marcador
+    }
 
     // Imprime resultados: solução, iterações, resíduo, tempo
     prnSolucao(sol, edo.n);
@@ -92,13 +468,8 @@ int main ()
     printf("  %.8e\n", tempo);
 
     // Libera memória alocada para esta EDO
-    free(sl->D);
-    free(sl->Di);
-    free(sl->Ds);
-    free(sl->B);
-    free(sl);
+    liberaTridiag(sl);
     free(sol);
-    free(marker_name);  // Libera string do nome do marcador
   }
 
   // Restaura modo de arredondamento padrão
@@ -107,4 +478,4 @@ int main ()
   LIKWID_MARKER_CLOSE;
   
   return 0;
-}
\ No newline at end of file
+}